@@ -0,0 +1,673 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include "sigparser/binaryinfo.h"
+#include "sigparser/compacttrie.h"
+#include "sigparser/corpusscan.h"
+#include "sigparser/flirtheatmap.h"
+#include "sigparser/flirtmatcher.h"
+#include "sigparser/flirtparser.h"
+#include "sigparser/frontcodeddict.h"
+#include "sigparser/matchcache.h"
+#include "sigparser/matchconfidence.h"
+#include "sigparser/matchprofile.h"
+#include "sigparser/prologuesketch.h"
+#include "sigparser/sigcatalogue.h"
+#include "sigparser/trieprofile.h"
+
+// Write data to the -o file, or stdout when no file was given
+static bool writeOutput(const QString &path, const QByteArray &data)
+{
+    QFile out;
+    if (path.isEmpty() || path == "-") {
+        if (!out.open(stdout, QIODevice::WriteOnly)) return false;
+    } else {
+        out.setFileName(path);
+        if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            QTextStream(stderr) << "Cannot write file: " << path << Qt::endl;
+            return false;
+        }
+    }
+    return out.write(data) == data.size();
+}
+
+static bool loadSig(const QString &path, SigParser::FlirtResult &result)
+{
+    SigParser::FlirtParser parser;
+    result = parser.parseFile(path);
+    if (!result.success) {
+        QTextStream(stderr) << path << ": " << result.errorMessage << Qt::endl;
+        return false;
+    }
+    return true;
+}
+
+static int runHeatMap(const QStringList &args, const QString &outPath)
+{
+    if (args.size() != 1) {
+        QTextStream(stderr) << "usage: sigviewer-cli heatmap <file.sig> [-o out.csv]" << Qt::endl;
+        return 2;
+    }
+    SigParser::FlirtResult result;
+    if (!loadSig(args.first(), result)) return 1;
+    return writeOutput(outPath, SigParser::computeBytePositionHistogram(result).toCsv()) ? 0 : 1;
+}
+
+static int runProfile(const QStringList &args, const QString &outPath)
+{
+    if (args.size() != 1) {
+        QTextStream(stderr) << "usage: sigviewer-cli profile <file.sig> [-o out.txt]" << Qt::endl;
+        return 2;
+    }
+    SigParser::FlirtResult result;
+    if (!loadSig(args.first(), result)) return 1;
+    QString text = SigParser::computeTrieProfile(result).toText();
+    const SigParser::CompactTrie compact = SigParser::CompactTrie::build(result);
+    text += QString("\nCompact (LOUDS) trie: %1 bytes, %2 bits per node\n")
+                .arg(compact.memoryBytes())
+                .arg(compact.nodeCount() ? 8.0 * compact.memoryBytes() / compact.nodeCount() : 0.0, 0, 'f', 1);
+    QVector<QByteArray> names;
+    qsizetype rawNameBytes = 0;
+    for (const SigParser::FlirtModule &mod : result.modules) {
+        for (const SigParser::FlirtFunction &f : mod.publicFunctions) {
+            names.append(f.name.toLatin1());
+            rawNameBytes += names.last().size();
+        }
+    }
+    const SigParser::FrontCodedDictionary dict = SigParser::FrontCodedDictionary::fromUnsorted(names);
+    text += QString("Front-coded names:    %1 distinct, %2 bytes (%3 bytes of names listed)\n")
+                .arg(dict.size()).arg(dict.memoryBytes()).arg(rawNameBytes);
+    return writeOutput(outPath, text.toUtf8()) ? 0 : 1;
+}
+
+// Synthetic image for the matcher benchmark: every module pattern (variant bytes filled at
+// random) followed by random filler, with one candidate at each pattern and one in the filler
+static QByteArray makeBenchImage(const SigParser::FlirtResult &result, int candidates, QVector<qsizetype> &offsets)
+{
+    std::mt19937 rng(1);
+    QByteArray image;
+    QVector<int> path;
+    while (offsets.size() < candidates) {
+        const SigParser::FlirtModule &mod = result.modules[rng() % result.modules.size()];
+        offsets.append(image.size());
+        path.clear();
+        for (int id = mod.leafNode; id > 0; id = result.nodes[id].parent)
+            path.prepend(id);
+        for (int id : path) {
+            const SigParser::FlirtPatternNode &node = result.nodes[id].pattern;
+            for (int i = 0; i < node.patternBytes.size(); ++i) {
+                const bool variant = i < node.variantMask.size() && node.variantMask[i];
+                image += variant ? static_cast<char>(rng()) : node.patternBytes[i];
+            }
+        }
+        for (int i = 0; i < 64; ++i)
+            image += static_cast<char>(rng());
+        offsets.append(image.size() - 32);
+    }
+    return image;
+}
+
+// Size of the largest CPU cache in bytes, or 0 when the platform does not tell
+static qint64 lastLevelCacheBytes()
+{
+    qint64 best = 0;
+    int bestLevel = 0;
+    for (int index = 0; index < 16; ++index) {
+        const QString dir = QString("/sys/devices/system/cpu/cpu0/cache/index%1/").arg(index);
+        QFile levelFile(dir + "level");
+        QFile sizeFile(dir + "size");
+        if (!levelFile.open(QIODevice::ReadOnly) || !sizeFile.open(QIODevice::ReadOnly)) break;
+        const int level = levelFile.readAll().trimmed().toInt();
+        QByteArray size = sizeFile.readAll().trimmed();  // "32768K"
+        qint64 unit = 1;
+        if (size.endsWith('K')) unit = 1024;
+        else if (size.endsWith('M')) unit = 1024 * 1024;
+        if (unit > 1) size.chop(1);
+        if (level >= bestLevel) {
+            bestLevel = level;
+            best = size.toLongLong() * unit;
+        }
+    }
+    return best;
+}
+
+// A flat trie of at least minBytes: three levels of 32-byte patterns under a root of 64, so
+// every candidate walks a few hundred nodes and most of them are cold
+static SigParser::FlirtResult makeSyntheticSig(qint64 minBytes)
+{
+    constexpr int PATTERN_LENGTH = 32;
+    constexpr int FANOUT = 64;
+    constexpr qint64 NODE_BYTES = 6 * 4 + 4 + 2 * PATTERN_LENGTH;  // FlatNode, child index, pattern and mask
+    const int leafFanout = static_cast<int>(qMax<qint64>(1, minBytes / NODE_BYTES / (FANOUT * FANOUT) + 1));
+    std::mt19937 rng(2);
+    SigParser::FlirtResult result;
+    result.success = true;
+    result.nodes.reserve(1 + FANOUT + FANOUT * FANOUT * (1 + leafFanout));
+    result.modules.reserve(FANOUT * FANOUT * leafFanout);
+    result.nodes.append(SigParser::FlirtTreeNode());
+    auto addNode = [&](int parent) {
+        SigParser::FlirtTreeNode node;
+        node.parent = parent;
+        node.depth = result.nodes[parent].depth + 1;
+        node.moduleBegin = result.modules.size();
+        for (int i = 0; i < PATTERN_LENGTH; ++i)
+            node.pattern.patternBytes += static_cast<char>(rng());
+        result.nodes[parent].children.append(result.nodes.size());
+        result.nodes.append(node);
+        return result.nodes.size() - 1;
+    };
+    // Pre-order with modules in leaf order, as the parser produces them
+    for (int a = 0; a < FANOUT; ++a) {
+        const int na = addNode(0);
+        for (int b = 0; b < FANOUT; ++b) {
+            const int nb = addNode(na);
+            for (int c = 0; c < leafFanout; ++c) {
+                const int leaf = addNode(nb);
+                SigParser::FlirtModule mod;
+                mod.leafNode = leaf;
+                mod.patternLength = mod.patternFixedBytes = 3 * PATTERN_LENGTH;
+                result.modules.append(mod);
+                result.nodes[leaf].moduleEnd = result.modules.size();
+            }
+            result.nodes[nb].moduleEnd = result.modules.size();
+        }
+        result.nodes[na].moduleEnd = result.modules.size();
+    }
+    result.nodes[0].moduleEnd = result.modules.size();
+    return result;
+}
+
+// Times matchOffsets() at several batch sizes; false when a batched run disagrees with batch 1
+static bool benchBatches(const SigParser::FlirtMatcher &matcher, const QByteArray &image,
+                         const QVector<qsizetype> &offsets, QString &text,
+                         QVector<SigParser::FlirtMatcher::OffsetCandidate> &reference, double &baseline)
+{
+    for (int batch : { 1, 8, 16, 32 }) {
+        QElapsedTimer timer;
+        timer.start();
+        const QVector<SigParser::FlirtMatcher::OffsetCandidate> found = matcher.matchOffsets(image, offsets, batch);
+        const double ns = static_cast<double>(timer.nsecsElapsed()) / offsets.size();
+        bool same = true;
+        if (batch == 1) {
+            reference = found;
+            baseline = ns;
+        } else {
+            same = found.size() == reference.size();
+            for (qsizetype i = 0; same && i < found.size(); ++i)
+                same = found[i].offset == reference[i].offset && found[i].module == reference[i].module
+                    && found[i].failed == reference[i].failed;
+        }
+        text += QString("batch %1: %2 ns/candidate, %3x, %4 candidates reached checks%5\n")
+                    .arg(batch, 2).arg(ns, 0, 'f', 1).arg(ns > 0 ? baseline / ns : 0.0, 0, 'f', 2)
+                    .arg(found.size()).arg(same ? QString() : QString("  MISMATCH"));
+        if (!same) return false;
+    }
+    return true;
+}
+
+static int runBench(const QStringList &args, const QString &outPath, const QString &profilePath)
+{
+    if (args.isEmpty() || args.size() > 2) {
+        QTextStream(stderr) << "usage: sigviewer-cli bench <file.sig> [candidates] [-p profile.fmp] [-o out.txt]" << Qt::endl;
+        return 2;
+    }
+    SigParser::FlirtResult result;
+    if (!loadSig(args.first(), result)) return 1;
+    if (result.modules.isEmpty()) {
+        QTextStream(stderr) << args.first() << ": no modules" << Qt::endl;
+        return 1;
+    }
+    const int candidates = args.size() > 1 ? qMax(1, args[1].toInt()) : 200000;
+    const SigParser::FlirtMatcher matcher = SigParser::FlirtMatcher::compile(result, SigParser::FlirtMatcher::Encoding::Flat);
+    QVector<qsizetype> offsets;
+    const QByteArray image = makeBenchImage(result, candidates, offsets);
+    const qint64 cacheBytes = lastLevelCacheBytes();
+
+    QString text;
+    text += QString("Trie: %1 nodes, %2 KiB flat; %3 candidates over %4 KiB\n")
+                .arg(result.nodes.size()).arg(matcher.trieMemoryBytes() / 1024)
+                .arg(offsets.size()).arg(image.size() / 1024);
+    text += cacheBytes > 0 ? QString("Last-level cache: %1 KiB\n").arg(cacheBytes / 1024)
+                           : QString("Last-level cache: unknown\n");
+    const SigParser::PrologueFilter *filter = matcher.prologueFilter();
+    if (filter->isSelective()) {
+        const qsizetype passed = filter->filterOffsets(image, offsets).size();
+        text += QString("Prologue filter: %1 KiB, %2 masks, %3% of candidates pass (%4 probes)\n")
+                    .arg(filter->memoryBytes() / 1024.0, 0, 'f', 1).arg(filter->maskCount())
+                    .arg(100.0 * passed / offsets.size(), 0, 'f', 1).arg(SigParser::PrologueFilter::probeKernel());
+    } else {
+        text += "Prologue filter: passes everything (unfixed prologue or too many masks)\n";
+    }
+    QVector<SigParser::FlirtMatcher::OffsetCandidate> reference;
+    double baseline = 0.0;
+    if (!benchBatches(matcher, image, offsets, text, reference, baseline)) {
+        writeOutput(outPath, text.toUtf8());
+        return 1;
+    }
+
+    // Batching hides cache misses, so a trie that stays cached shows little gain; repeat on a
+    // synthetic trie twice the cache size (64 MiB when the size is unknown)
+    if (cacheBytes <= 0 || matcher.trieMemoryBytes() <= cacheBytes) {
+        const SigParser::FlirtResult synthetic = makeSyntheticSig(cacheBytes > 0 ? 2 * cacheBytes : qint64(64) << 20);
+        const SigParser::FlirtMatcher large = SigParser::FlirtMatcher::compile(synthetic, SigParser::FlirtMatcher::Encoding::Flat);
+        QVector<qsizetype> largeOffsets;
+        const QByteArray largeImage = makeBenchImage(synthetic, candidates, largeOffsets);
+        text += QString("Trie fits in the cache; synthetic trie: %1 nodes, %2 KiB flat; %3 candidates over %4 KiB\n")
+                    .arg(synthetic.nodes.size()).arg(large.trieMemoryBytes() / 1024)
+                    .arg(largeOffsets.size()).arg(largeImage.size() / 1024);
+        QVector<SigParser::FlirtMatcher::OffsetCandidate> largeReference;
+        double largeBaseline = 0.0;
+        if (!benchBatches(large, largeImage, largeOffsets, text, largeReference, largeBaseline)) {
+            writeOutput(outPath, text.toUtf8());
+            return 1;
+        }
+    }
+
+    // Profile-guided layout: a saved profile when one is given and fits, else one recorded now
+    SigParser::MatchProfile profile;
+    bool loaded = false;
+    QFile profileFile(profilePath);
+    if (!profilePath.isEmpty() && profileFile.open(QIODevice::ReadOnly))
+        loaded = SigParser::MatchProfile::fromBytes(profileFile.readAll(), profile) && profile.fits(result);
+    profileFile.close();
+    if (!loaded) {
+        profile = SigParser::MatchProfile::forResult(result);
+        matcher.matchOffsets(image, offsets, 16, &profile);
+        if (!profilePath.isEmpty()) {
+            if (profileFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+                profileFile.write(profile.toBytes());
+            else
+                QTextStream(stderr) << "Cannot write file: " << profilePath << Qt::endl;
+        }
+    }
+    const SigParser::FlirtMatcher guided = SigParser::FlirtMatcher::compile(result, SigParser::FlirtMatcher::Encoding::Flat, &profile);
+    text += loaded ? QString("Profile-guided layout (profile from %1):\n").arg(profilePath)
+                   : QString("Profile-guided layout (profile recorded on this image):\n");
+    // How far the layout moved from file order, so a profile that changes nothing is visible
+    int moved = 0;
+    for (int i = 0; i < guided.nodeLayout().size(); ++i)
+        moved += guided.nodeLayout()[i] != i;
+    int reordered = 0;
+    for (const SigParser::FlirtTreeNode &node : result.nodes) {
+        for (int c = 1; c < node.children.size(); ++c) {
+            if (profile.nodePasses[node.children[c - 1]] < profile.nodePasses[node.children[c]]) {
+                ++reordered;
+                break;
+            }
+        }
+    }
+    text += QString("%1 of %2 nodes placed away from file order, %3 child lists reordered\n")
+                .arg(moved).arg(result.nodes.size()).arg(reordered);
+    for (int batch : { 1, 16 }) {
+        QElapsedTimer timer;
+        timer.start();
+        const qsizetype found = guided.matchOffsets(image, offsets, batch).size();
+        const double ns = static_cast<double>(timer.nsecsElapsed()) / offsets.size();
+        text += QString("batch %1: %2 ns/candidate, %3x%4\n")
+                    .arg(batch, 2).arg(ns, 0, 'f', 1).arg(ns > 0 ? baseline / ns : 0.0, 0, 'f', 2)
+                    .arg(found == reference.size() ? QString() : QString("  MISMATCH"));
+        if (found != reference.size()) {
+            writeOutput(outPath, text.toUtf8());
+            return 1;
+        }
+    }
+    return writeOutput(outPath, text.toUtf8()) ? 0 : 1;
+}
+
+static int runSelect(const QStringList &args, const QString &outPath)
+{
+    if (args.size() != 2) {
+        QTextStream(stderr) << "usage: sigviewer-cli select <binary> <catalogue-dir> [-o out.txt]" << Qt::endl;
+        return 2;
+    }
+    QString error;
+    const SigParser::BinaryInfo binary = SigParser::probeBinaryFile(args[0], &error);
+    if (!binary.isValid()) {
+        QTextStream(stderr) << error << Qt::endl;
+        return 1;
+    }
+    const QVector<SigParser::CatalogueEntry> entries = SigParser::scanCatalogue(args[1]);
+    QStringList rejections;
+    const QVector<int> selected = SigParser::selectSignatures(entries, binary, &rejections);
+
+    QString text;
+    QTextStream ts(&text);
+    ts << args[0] << ": " << binary.description << "\n";
+    ts << "  arch " << SigParser::archToString(binary.arch)
+       << ", file type " << SigParser::fileTypesToString(binary.fileType)
+       << ", OS " << SigParser::osTypesToString(binary.osType)
+       << ", app " << SigParser::appTypesToString(binary.appType) << "\n\n";
+    ts << "Compatible signatures (" << selected.size() << " of " << entries.size() << "):\n";
+    for (int i : selected)
+        ts << "  " << entries[i].path << "  " << entries[i].libraryName << "\n";
+    if (!rejections.isEmpty()) {
+        ts << "\nSkipped:\n";
+        for (const QString &r : rejections)
+            ts << "  " << r << "\n";
+    }
+    ts.flush();
+    return writeOutput(outPath, text.toUtf8()) ? 0 : 1;
+}
+
+static int runSketch(const QStringList &args, const QString &outPath)
+{
+    if (args.size() != 1 || outPath.isEmpty()) {
+        QTextStream(stderr) << "usage: sigviewer-cli sketch <catalogue-dir> -o sketches.fsk" << Qt::endl;
+        return 2;
+    }
+    QStringList paths;
+    for (const SigParser::CatalogueEntry &e : SigParser::scanCatalogue(args.first())) {
+        if (e.error.isEmpty()) paths << e.path;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    const QVector<SigParser::PrologueSketch> sketches = QtConcurrent::blockingMapped<QVector<SigParser::PrologueSketch>>(
+        paths, [](const QString &path) {
+            SigParser::FlirtParser parser;
+            const SigParser::FlirtResult result = parser.parseFile(path);
+            return result.success ? SigParser::PrologueSketch::build(result, path) : SigParser::PrologueSketch();
+        });
+    int empty = 0;
+    for (const SigParser::PrologueSketch &sketch : sketches) {
+        if (sketch.isEmpty()) ++empty;
+    }
+    QTextStream(stderr) << "Sketched " << sketches.size() << " signatures (" << empty << " without usable prologues) in "
+                        << timer.elapsed() << " ms" << Qt::endl;
+    return writeOutput(outPath, SigParser::sketchesToBytes(sketches)) ? 0 : 1;
+}
+
+static int runRank(const QStringList &args, const QString &outPath, double minConfidence)
+{
+    if (args.size() < 2 || args.size() > 3) {
+        QTextStream(stderr) << "usage: sigviewer-cli rank <binary> <sketches.fsk> [top-n] [-o out.txt]" << Qt::endl;
+        return 2;
+    }
+    QFile binaryFile(args[0]);
+    QFile sketchFile(args[1]);
+    if (!binaryFile.open(QIODevice::ReadOnly) || !sketchFile.open(QIODevice::ReadOnly)) {
+        QTextStream(stderr) << "Cannot open file: " << (binaryFile.isOpen() ? args[1] : args[0]) << Qt::endl;
+        return 1;
+    }
+    QVector<SigParser::PrologueSketch> sketches;
+    if (!SigParser::sketchesFromBytes(sketchFile.readAll(), sketches)) {
+        QTextStream(stderr) << args[1] << ": not a sketch file" << Qt::endl;
+        return 1;
+    }
+    const QByteArray image = binaryFile.readAll();
+    const int topN = args.size() > 2 ? qMax(1, args[2].toInt()) : 10;
+
+    // Signatures whose header rules the binary out are not ranked at all
+    const SigParser::BinaryInfo binary = SigParser::probeBinary(image.left(4096));
+    QVector<SigParser::PrologueSketch> compatible;
+    for (const SigParser::PrologueSketch &sketch : sketches) {
+        if (!binary.isValid() || SigParser::signatureIncompatibility(sketch.header, binary).isEmpty())
+            compatible.append(sketch);
+    }
+    // Same starts as a corpus scan: every byte on x86
+    const int alignment = SigParser::scanAlignment(SigParser::CorpusScanOptions(),
+                                                   binary.isValid() ? binary.arch : SigParser::IDASIG_ARCH_386);
+
+    QString text;
+    QElapsedTimer timer;
+    timer.start();
+    const QVector<qsizetype> samples = SigParser::sampleFunctionStarts(image, alignment, 32768);
+    const QVector<SigParser::SketchRank> ranks = SigParser::rankSketches(compatible, image, samples);
+    text += QString("%1: %2\nRanked %3 of %4 sketches over %5 sampled starts in %6 ms\n\n")
+                .arg(args[0], binary.isValid() ? binary.description : QString("unknown format"))
+                .arg(compatible.size()).arg(sketches.size()).arg(samples.size()).arg(timer.elapsed());
+
+    // Full matching at every start, for the top-ranked signatures only. Starts go to the
+    // matcher a slice at a time: at stride 1 the full list would take 8 bytes per image byte.
+    const qsizetype lastStart = image.size() - SigParser::PrologueSketch::PROLOGUE_BYTES;
+    QVector<qsizetype> slice;
+    text += "containment  hits  matches  signature\n";
+    for (int i = 0; i < ranks.size() && i < topN; ++i) {
+        const SigParser::PrologueSketch &sketch = compatible[ranks[i].sketch];
+        SigParser::FlirtResult result;
+        int matches = -1;
+        if (ranks[i].hits > 0 && loadSig(sketch.path, result)) {
+            matches = 0;
+            const SigParser::FlirtMatcher matcher = SigParser::FlirtMatcher::compile(result);
+            for (qsizetype begin = 0; begin <= lastStart; begin += qsizetype(alignment) << 16) {
+                slice.clear();
+                for (qsizetype pos = begin; pos <= lastStart && slice.size() < (1 << 16); pos += alignment)
+                    slice.append(pos);
+                // References are not resolved here, so this is the confidence's lower bound
+                for (const SigParser::FlirtMatcher::OffsetCandidate &c : matcher.matchOffsets(image, slice)) {
+                    if (c.failed == SigParser::FlirtMatcher::Check::None
+                        && SigParser::matchConfidence(result.modules[c.module]) >= minConfidence)
+                        ++matches;
+                }
+            }
+        }
+        text += QString("%1  %2  %3  %4 (%5)\n")
+                    .arg(ranks[i].containment, 11, 'f', 3).arg(ranks[i].hits, 4)
+                    .arg(matches >= 0 ? QString::number(matches) : QString("-"), 7)
+                    .arg(sketch.path, sketch.libraryName);
+    }
+    text += QString("\nTotal %1 ms\n").arg(timer.elapsed());
+    return writeOutput(outPath, text.toUtf8()) ? 0 : 1;
+}
+
+// .sig files, or every readable signature under a catalogue directory, parsed and compiled once;
+// every corpus worker shares the same read-only matchers
+static QVector<SigParser::CorpusSignature> loadCorpusSignatures(const QStringList &args)
+{
+    QStringList sigPaths;
+    for (const QString &arg : args) {
+        if (!QFileInfo(arg).isDir()) {
+            sigPaths << arg;
+            continue;
+        }
+        for (const SigParser::CatalogueEntry &e : SigParser::scanCatalogue(arg)) {
+            if (e.error.isEmpty()) sigPaths << e.path;
+        }
+    }
+    const QVector<SigParser::CorpusSignature> loaded = QtConcurrent::blockingMapped<QVector<SigParser::CorpusSignature>>(
+        sigPaths, [](const QString &path) {
+            SigParser::CorpusSignature sig;
+            sig.name = QFileInfo(path).fileName();
+            SigParser::FlirtParser parser;
+            const SigParser::FlirtResult result = parser.parseFile(path);
+            if (result.success)
+                sig.matcher = std::make_shared<const SigParser::FlirtMatcher>(SigParser::FlirtMatcher::compile(result));
+            else
+                QTextStream(stderr) << path << ": " << result.errorMessage << Qt::endl;
+            return sig;
+        });
+    QVector<SigParser::CorpusSignature> signatures;
+    for (const SigParser::CorpusSignature &sig : loaded) {
+        if (sig.matcher) signatures.append(sig);
+    }
+    return signatures;
+}
+
+static int runCorpus(const QStringList &args, const QString &outPath, SigParser::CorpusScanOptions options,
+                     const QString &cacheDir)
+{
+    if (args.size() < 2) {
+        QTextStream(stderr) << "usage: sigviewer-cli corpus <binaries-dir> <file.sig|catalogue-dir>... [-j jobs] [-o out.ndjson]" << Qt::endl;
+        return 2;
+    }
+    const QVector<SigParser::CorpusSignature> signatures = loadCorpusSignatures(args.mid(1));
+    if (signatures.isEmpty()) {
+        QTextStream(stderr) << "No signatures loaded" << Qt::endl;
+        return 1;
+    }
+
+    QFile out;
+    if (outPath.isEmpty() || outPath == "-") {
+        out.open(stdout, QIODevice::WriteOnly);
+    } else {
+        out.setFileName(outPath);
+        if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            QTextStream(stderr) << "Cannot write file: " << outPath << Qt::endl;
+            return 1;
+        }
+    }
+    std::unique_ptr<SigParser::MatchCache> cache;
+    if (!cacheDir.isEmpty())
+        cache = std::make_unique<SigParser::MatchCache>(cacheDir == "default" ? SigParser::MatchCache::defaultDirectory() : cacheDir);
+    options.cache = cache.get();
+    const QVector<SigParser::CorpusFile> files = SigParser::listCorpus(args.first());
+    bool writeOk = true;
+    const SigParser::CorpusStats stats = SigParser::scanCorpus(files, signatures, options, [&](const SigParser::CorpusFileResult &r) {
+        const QByteArray line = r.toNdjson(signatures);
+        writeOk = out.write(line) == line.size() && out.flush();
+        return writeOk;
+    });
+    out.write(stats.toNdjson());
+    QTextStream(stderr) << QString("%1 files (%2 failed), %3 MiB in %4 s on %5 threads: %6 MiB/s, %7 matches, %8 overlaps and %9 below confidence dropped")
+                               .arg(stats.files).arg(stats.failed).arg(stats.bytes / (1024.0 * 1024.0), 0, 'f', 1)
+                               .arg(stats.wallNs / 1e9, 0, 'f', 2).arg(stats.threads)
+                               .arg(stats.wallNs > 0 ? (stats.bytes / (1024.0 * 1024.0)) / (stats.wallNs / 1e9) : 0.0, 0, 'f', 1)
+                               .arg(stats.matches).arg(stats.conflicts).arg(stats.belowThreshold)
+                        << (cache ? QString(", %1 cached").arg(stats.cacheHits) : QString()) << Qt::endl;
+    return writeOk ? 0 : 1;
+}
+
+// Identify library methods in the classes*.dex of an unpacked APK: one row per matched method
+static int runDex(const QStringList &args, const QString &outPath, SigParser::CorpusScanOptions options)
+{
+    if (args.size() < 2) {
+        QTextStream(stderr) << "usage: sigviewer-cli dex <file.sig|catalogue-dir> <classes.dex|apk-dir>... [-j jobs] [-o out.tsv]" << Qt::endl;
+        return 2;
+    }
+    const QVector<SigParser::CorpusSignature> signatures = loadCorpusSignatures(args.mid(0, 1));
+    if (signatures.isEmpty()) {
+        QTextStream(stderr) << "No signatures loaded" << Qt::endl;
+        return 1;
+    }
+    QVector<SigParser::CorpusFile> files;
+    for (const QString &arg : args.mid(1)) {
+        const QFileInfo info(arg);
+        if (!info.isDir()) {
+            files.append({ arg, info.size() });
+            continue;
+        }
+        for (const SigParser::CorpusFile &f : SigParser::listCorpus(arg)) {
+            const QString name = QFileInfo(f.path).fileName();
+            if (name.startsWith("classes") && name.endsWith(".dex")) files.append(f);
+        }
+    }
+    std::stable_sort(files.begin(), files.end(), [](const SigParser::CorpusFile &a, const SigParser::CorpusFile &b) {
+        return a.size != b.size ? a.size > b.size : a.path < b.path;
+    });
+
+    QByteArray out = "dex\tmethod_id\tmethod\tsignature\tfunction\tconfidence\n";
+    int methods = 0;
+    int matched = 0;
+    const SigParser::CorpusStats stats = SigParser::scanCorpus(files, signatures, options, [&](const SigParser::CorpusFileResult &r) {
+        if (!r.error.isEmpty()) {
+            QTextStream(stderr) << r.path << ": " << r.error << Qt::endl;
+            return true;
+        }
+        if (!r.format.startsWith("DEX ")) {
+            QTextStream(stderr) << r.path << ": not a DEX file" << Qt::endl;
+            return true;
+        }
+        methods += r.methods.size();
+        for (const SigParser::CorpusMatch &m : r.matches) {
+            const SigParser::DexMethod *method = r.methodAt(m.offset);
+            if (!method) continue;
+            const SigParser::FlirtModule &mod = signatures[m.signature].matcher->result().modules[m.module];
+            const QString function = mod.publicFunctions.isEmpty() ? QString() : mod.publicFunctions.first().name;
+            out += QString("%1\t%2\t%3\t%4\t%5\t%6\n").arg(QFileInfo(r.path).fileName()).arg(method->methodId)
+                       .arg(method->name, signatures[m.signature].name, function).arg(m.confidence, 0, 'f', 3).toUtf8();
+            ++matched;
+        }
+        return true;
+    });
+    QTextStream(stderr) << QString("%1 dex files, %2 methods with code, %3 identified in %4 s on %5 threads")
+                               .arg(stats.files).arg(methods).arg(matched).arg(stats.wallNs / 1e9, 0, 'f', 2).arg(stats.threads)
+                        << Qt::endl;
+    return writeOutput(outPath, out) ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("sigviewer-cli");
+
+    QCommandLineParser cmd;
+    cmd.setApplicationDescription("Command line tools for FLIRT .sig files.\n\n"
+                                  "Commands:\n"
+                                  "  heatmap <file.sig>   64 x 256 byte-per-position histogram as CSV\n"
+                                  "  profile <file.sig>   trie shape report with matcher layout recommendations\n"
+                                  "  bench <file.sig> [n] one-at-a-time vs batched trie matching over n synthetic candidates\n"
+                                  "  select <bin> <dir>   signatures under dir whose header fits the binary's format, arch and bitness\n"
+                                  "  sketch <dir>         prologue MinHash sketches of every signature under dir (needs -o)\n"
+                                  "  rank <bin> <fsk> [n] rank sketched signatures by estimated presence, fully match the top n\n"
+                                  "  corpus <dir> <sigs>  scan every binary under dir, largest first, as NDJSON (-c to cache results)\n"
+                                  "  dex <sigs> <dex>...  name the Dalvik methods in classes*.dex files (or unpacked APK dirs) as TSV");
+    cmd.addHelpOption();
+    cmd.addPositionalArgument("command", "Command to run.");
+    cmd.addPositionalArgument("args", "Command arguments.", "[args...]");
+    QCommandLineOption outputOption(QStringList() << "o" << "output", "Write output to <file> instead of stdout.", "file");
+    cmd.addOption(outputOption);
+    QCommandLineOption profileOption(QStringList() << "p" << "profile",
+                                     "bench: match profile to lay the trie out with; recorded and saved there when missing.", "file");
+    cmd.addOption(profileOption);
+    QCommandLineOption jobsOption(QStringList() << "j" << "jobs", "corpus, dex: worker threads (default: one per core).", "n");
+    cmd.addOption(jobsOption);
+    QCommandLineOption cacheOption(QStringList() << "c" << "cache",
+                                   "corpus: reuse and store results in the match cache at <dir> (\"default\" for the per-user one).", "dir");
+    cmd.addOption(cacheOption);
+    QCommandLineOption confidenceOption(QStringList() << "m" << "min-confidence",
+                                        "corpus, dex, rank: drop matches with confidence below <c> (0 to 1).", "c", "0");
+    cmd.addOption(confidenceOption);
+    QCommandLineOption alignmentOption(QStringList() << "a" << "alignment",
+                                       "corpus, dex: step between candidate function starts in bytes "
+                                       "(default: 1 on x86, the instruction size elsewhere).", "n", "0");
+    cmd.addOption(alignmentOption);
+    cmd.process(app);
+
+    QStringList args = cmd.positionalArguments();
+    if (args.isEmpty()) cmd.showHelp(2);
+    const QString command = args.takeFirst();
+    const QString outPath = cmd.value(outputOption);
+
+    if (command == "heatmap") return runHeatMap(args, outPath);
+    if (command == "profile") return runProfile(args, outPath);
+    bool confidenceOk = false;
+    const double minConfidence = cmd.value(confidenceOption).toDouble(&confidenceOk);
+    if (!confidenceOk || minConfidence < 0.0 || minConfidence > 1.0) {
+        QTextStream(stderr) << "--min-confidence must be between 0 and 1" << Qt::endl;
+        return 2;
+    }
+    // 0 picks the step by architecture
+    const int alignment = cmd.value(alignmentOption).toInt();
+    if (alignment < 0) {
+        QTextStream(stderr) << "--alignment must not be negative" << Qt::endl;
+        return 2;
+    }
+
+    if (command == "corpus") {
+        SigParser::CorpusScanOptions options;
+        options.threads = cmd.value(jobsOption).toInt();
+        options.minConfidence = minConfidence;
+        options.alignment = alignment;
+        return runCorpus(args, outPath, options, cmd.value(cacheOption));
+    }
+    if (command == "dex") {
+        SigParser::CorpusScanOptions options;
+        options.threads = cmd.value(jobsOption).toInt();
+        options.minConfidence = minConfidence;
+        options.alignment = alignment;
+        return runDex(args, outPath, options);
+    }
+    if (command == "sketch") return runSketch(args, outPath);
+    if (command == "rank") return runRank(args, outPath, minConfidence);
+    if (command == "select") return runSelect(args, outPath);
+    if (command == "bench") return runBench(args, outPath, cmd.value(profileOption));
+
+    QTextStream(stderr) << "Unknown command: " << command << Qt::endl;
+    return 2;
+}
@@ -0,0 +1,201 @@
+#include "functionsmodel.h"
+#include <algorithm>
+
+FunctionsModel::FunctionsModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+void FunctionsModel::setResult(const SigParser::FlirtResult &result)
+{
+    if (m_loading && result.modules.size() == m_result.modules.size()) {
+        // Same modules that were streamed in; only the metadata is new
+        m_result = result;
+        m_loading = false;
+        return;
+    }
+    beginResetModel();
+    m_result = result;
+    m_rows.clear();
+    m_signatureHex.clear();
+    m_signatureRank.clear();
+    m_loading = false;
+    appendRows(0);
+    endResetModel();
+}
+
+void FunctionsModel::clear()
+{
+    beginResetModel();
+    m_rows.clear();
+    m_result = SigParser::FlirtResult();
+    m_signatureHex.clear();
+    m_signatureRank.clear();
+    m_loading = false;
+    endResetModel();
+}
+
+void FunctionsModel::beginLoading()
+{
+    clear();
+    m_loading = true;
+}
+
+void FunctionsModel::appendModules(const QVector<SigParser::FlirtModule> &batch)
+{
+    if (!m_loading || batch.isEmpty()) return;
+    qsizetype functions = 0;
+    for (const auto &mod : batch)
+        functions += mod.publicFunctions.size();
+    if (!functions) {
+        m_result.modules.append(batch);
+        return;
+    }
+    const int firstModule = m_result.modules.size();
+    const int firstRow = m_rows.size();
+    beginInsertRows(QModelIndex(), firstRow, firstRow + functions - 1);
+    m_result.modules.append(batch);
+    appendRows(firstModule);
+    endInsertRows();
+}
+
+void FunctionsModel::appendRows(int firstModule)
+{
+    for (int mi = firstModule; mi < m_result.modules.size(); ++mi) {
+        const int n = m_result.modules[mi].publicFunctions.size();
+        for (int fi = 0; fi < n; ++fi)
+            m_rows.append({ mi, fi });
+    }
+}
+
+SigParser::FlirtResult::FunctionEntry FunctionsModel::entry(int row) const
+{
+    SigParser::FlirtResult::FunctionEntry e;
+    if (row < 0 || row >= m_rows.size()) return e;
+    const Row &r = m_rows[row];
+    e.moduleIndex = r.module;
+    e.module = &m_result.modules[r.module];
+    e.function = &e.module->publicFunctions[r.function];
+    return e;
+}
+
+QString FunctionsModel::signatureHex(int module) const
+{
+    if (module < 0 || module >= m_result.modules.size()) return QString();
+    while (m_signatureHex.size() <= module)
+        m_signatureHex.append(m_result.modules[m_signatureHex.size()].patternPathHex());
+    return m_signatureHex[module];
+}
+
+int FunctionsModel::signatureRank(int module) const
+{
+    // Modules only grow while loading, so a size mismatch means the ranks are stale
+    if (m_signatureRank.size() != m_result.modules.size()) {
+        QVector<int> order(m_result.modules.size());
+        for (int i = 0; i < order.size(); ++i)
+            order[i] = i;
+        signatureHex(order.size() - 1);
+        std::stable_sort(order.begin(), order.end(), [this](int a, int b) { return m_signatureHex[a] < m_signatureHex[b]; });
+        m_signatureRank.resize(order.size());
+        for (int i = 0; i < order.size(); ++i)
+            m_signatureRank[order[i]] = i;
+    }
+    return m_signatureRank.value(module);
+}
+
+int FunctionsModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+int FunctionsModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant FunctionsModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size()) return QVariant();
+    if (role == EntryIndexRole) return index.row();
+    const SigParser::FlirtResult::FunctionEntry e = entry(index.row());
+    if (role == SortRole) {
+        switch (index.column()) {
+        case ModuleColumn: return e.moduleIndex;
+        case OffsetColumn: return e.function->offset;
+        case LocalColumn: return e.function->isLocal;
+        case CollisionColumn: return e.function->isCollision;
+        case SignatureColumn: return signatureRank(e.moduleIndex);
+        default: break;  // text columns sort by display text
+        }
+    }
+    if (role != Qt::DisplayRole && role != SortRole) return QVariant();
+    switch (index.column()) {
+    case ModuleColumn: return QString::number(e.moduleIndex);
+    case NameColumn: return e.function->name;
+    case OffsetColumn: return QString("0x%1").arg(e.function->offset, 0, 16);
+    case LocalColumn: return e.function->isLocal ? QString("Y") : QString();
+    case CollisionColumn: return e.function->isCollision ? QString("!") : QString();
+    case SignatureColumn: return signatureHex(e.moduleIndex);  // painted by SignatureDelegate
+    default: return QVariant();
+    }
+}
+
+QVariant FunctionsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return QVariant();
+    switch (section) {
+    case ModuleColumn: return tr("Module");
+    case NameColumn: return tr("Name");
+    case OffsetColumn: return tr("Offset");
+    case LocalColumn: return tr("Local");
+    case CollisionColumn: return tr("Collision");
+    case SignatureColumn: return tr("Signature");
+    default: return QVariant();
+    }
+}
+
+FunctionsFilterModel::FunctionsFilterModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+    setSortRole(FunctionsModel::SortRole);
+}
+
+void FunctionsFilterModel::setFilterText(const QString &text, const QBitArray &nameMatches)
+{
+    m_text = text;
+    m_nameMatches = nameMatches;
+    m_ranked = false;
+    m_rank.clear();
+    invalidate();
+}
+
+void FunctionsFilterModel::setRankedRows(const QHash<int, int> &rankBySourceRow)
+{
+    m_text.clear();
+    m_nameMatches.clear();
+    m_ranked = true;
+    m_rank = rankBySourceRow;
+    invalidate();
+}
+
+bool FunctionsFilterModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    if (m_ranked)
+        return m_rank.value(left.row()) < m_rank.value(right.row());
+    return QSortFilterProxyModel::lessThan(left, right);
+}
+
+bool FunctionsFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    if (m_ranked) return m_rank.contains(sourceRow);
+    if (m_text.isEmpty()) return true;
+    const bool namesKnown = sourceRow < m_nameMatches.size();
+    if (namesKnown && m_nameMatches.testBit(sourceRow)) return true;
+    const QAbstractItemModel *src = sourceModel();
+    for (int col = 0; col < src->columnCount(sourceParent); ++col) {
+        if (namesKnown && col == FunctionsModel::NameColumn) continue;
+        if (src->index(sourceRow, col, sourceParent).data().toString().contains(m_text, Qt::CaseInsensitive))
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,83 @@
+#ifndef FUNCTIONSMODEL_H
+#define FUNCTIONSMODEL_H
+
+#include <QAbstractTableModel>
+#include <QBitArray>
+#include <QHash>
+#include <QSortFilterProxyModel>
+#include "sigparser/flirtparser.h"
+
+// Flattened public functions of one signature, one row per FlirtResult::allFunctions() entry.
+// While a file is loading, modules are appended in batches as the parser publishes them.
+class FunctionsModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column { ModuleColumn, NameColumn, OffsetColumn, LocalColumn, CollisionColumn, SignatureColumn, ColumnCount };
+    enum Role {
+        EntryIndexRole = Qt::UserRole + 1,  // row in this (source) model
+        SortRole
+    };
+
+    explicit FunctionsModel(QObject *parent = nullptr);
+
+    /** Adopt a fully parsed result; keeps the rows (no reset) when it completes the current load. */
+    void setResult(const SigParser::FlirtResult &result);
+    void clear();
+    void beginLoading();
+    void appendModules(const QVector<SigParser::FlirtModule> &batch);
+    bool isLoading() const { return m_loading; }
+    const SigParser::FlirtResult &result() const { return m_result; }
+    /** Entry for a source row; pointers are null when the row is out of range. */
+    SigParser::FlirtResult::FunctionEntry entry(int row) const;
+    /** Pattern path hex of a module, built once per module for filtering and display. */
+    QString signatureHex(int module) const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    // Indices rather than pointers: m_result.modules grows while loading
+    struct Row {
+        int module = 0;
+        int function = 0;
+    };
+    void appendRows(int firstModule);
+    int signatureRank(int module) const;
+
+    SigParser::FlirtResult m_result;
+    QVector<Row> m_rows;
+    mutable QVector<QString> m_signatureHex;  // per module, filled on first use
+    mutable QVector<int> m_signatureRank;     // per module: position in hex order, for sorting
+    bool m_loading = false;
+};
+
+// Search box filter: case-insensitive "any column contains", or a ranked set of rows
+// (fuzzy results) that are shown alone and sorted by rank.
+class FunctionsFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit FunctionsFilterModel(QObject *parent = nullptr);
+
+    /** nameMatches, when given, holds one bit per source row whose name already matched text. */
+    void setFilterText(const QString &text, const QBitArray &nameMatches = QBitArray());
+    void setRankedRows(const QHash<int, int> &rankBySourceRow);
+    bool isRanked() const { return m_ranked; }
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
+private:
+    QString m_text;
+    QBitArray m_nameMatches;
+    bool m_ranked = false;
+    QHash<int, int> m_rank;
+};
+
+#endif // FUNCTIONSMODEL_H
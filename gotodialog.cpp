@@ -0,0 +1,100 @@
+#include "gotodialog.h"
+#include "functionsmodel.h"
+#include <QCoreApplication>
+#include <QKeyEvent>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QVBoxLayout>
+
+static constexpr int GOTO_MAX_RESULTS = 200;
+
+GotoDialog::GotoDialog(const FunctionsModel *model, QWidget *parent)
+    : QDialog(parent)
+    , m_model(model)
+{
+    setWindowTitle(tr("Go to"));
+    resize(520, 360);
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    m_queryEdit = new QLineEdit();
+    m_queryEdit->setPlaceholderText(tr("Name, 0x offset or #module"));
+    m_queryEdit->installEventFilter(this);
+    layout->addWidget(m_queryEdit);
+    m_resultsList = new QListWidget();
+    m_resultsList->setUniformItemSizes(true);
+    layout->addWidget(m_resultsList);
+    connect(m_queryEdit, &QLineEdit::textChanged, this, &GotoDialog::onQueryChanged);
+    connect(m_queryEdit, &QLineEdit::returnPressed, this, [this]() {
+        if (QListWidgetItem *item = m_resultsList->currentItem())
+            onItemActivated(item);
+    });
+    connect(m_resultsList, &QListWidget::itemActivated, this, &GotoDialog::onItemActivated);
+}
+
+void GotoDialog::setIndex(std::shared_ptr<const SigParser::FunctionIndex> index)
+{
+    m_index = std::move(index);
+    onQueryChanged(m_queryEdit->text());
+}
+
+void GotoDialog::open()
+{
+    m_queryEdit->clear();
+    m_resultsList->clear();
+    QDialog::open();
+    m_queryEdit->setFocus();
+}
+
+void GotoDialog::addRow(int ordinal)
+{
+    const SigParser::FlirtResult::FunctionEntry e = m_model->entry(ordinal);
+    if (!e.function) return;
+    QListWidgetItem *item = new QListWidgetItem(
+        QString("%1    #%2  0x%3").arg(e.function->name).arg(e.moduleIndex).arg(e.function->offset, 0, 16));
+    item->setData(Qt::UserRole, ordinal);
+    m_resultsList->addItem(item);
+}
+
+void GotoDialog::onQueryChanged(const QString &text)
+{
+    m_resultsList->clear();
+    const QString q = text.trimmed();
+    if (!m_index || q.isEmpty()) return;
+
+    QVector<int> hits;
+    bool ok = false;
+    if (q.startsWith("0x", Qt::CaseInsensitive)) {
+        const quint32 offset = q.mid(2).toUInt(&ok, 16);
+        if (ok) hits = m_index->findOffset(offset, GOTO_MAX_RESULTS);
+    } else if (q.startsWith('#')) {
+        const int module = q.mid(1).toInt(&ok);
+        const int first = ok ? m_index->moduleFirstFunction(module) : -1;
+        if (first >= 0) hits.append(first);
+    }
+    if (!ok) {
+        // Keys are sorted, so an exact match comes first among the prefix matches
+        hits = m_index->findName(q, true, GOTO_MAX_RESULTS);
+    }
+    for (int ordinal : hits)
+        addRow(ordinal);
+    if (m_resultsList->count())
+        m_resultsList->setCurrentRow(0);
+}
+
+void GotoDialog::onItemActivated(QListWidgetItem *item)
+{
+    emit functionChosen(item->data(Qt::UserRole).toInt());
+    accept();
+}
+
+bool GotoDialog::eventFilter(QObject *watched, QEvent *event)
+{
+    // Up/Down in the query box move through the results
+    if (watched == m_queryEdit && event->type() == QEvent::KeyPress) {
+        const int key = static_cast<QKeyEvent *>(event)->key();
+        if (key == Qt::Key_Up || key == Qt::Key_Down || key == Qt::Key_PageUp || key == Qt::Key_PageDown) {
+            QCoreApplication::sendEvent(m_resultsList, event);
+            return true;
+        }
+    }
+    return QDialog::eventFilter(watched, event);
+}
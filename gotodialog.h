@@ -0,0 +1,44 @@
+#ifndef GOTODIALOG_H
+#define GOTODIALOG_H
+
+#include <QDialog>
+#include <memory>
+#include "sigparser/functionindex.h"
+
+class QLineEdit;
+class QListWidget;
+class QListWidgetItem;
+class FunctionsModel;
+
+// Go-to palette: "name" (exact, then prefix), "0x1a2b" (function offset) or "#12" (module)
+class GotoDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    GotoDialog(const FunctionsModel *model, QWidget *parent = nullptr);
+
+    void setIndex(std::shared_ptr<const SigParser::FunctionIndex> index);
+    /** Show with an empty query and focus the input. */
+    void open() override;
+
+signals:
+    void functionChosen(int sourceRow);
+
+private slots:
+    void onQueryChanged(const QString &text);
+    void onItemActivated(QListWidgetItem *item);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    void addRow(int ordinal);
+
+    const FunctionsModel *m_model;
+    std::shared_ptr<const SigParser::FunctionIndex> m_index;
+    QLineEdit *m_queryEdit;
+    QListWidget *m_resultsList;
+};
+
+#endif // GOTODIALOG_H
@@ -0,0 +1,130 @@
+#include "heatmapwidget.h"
+#include <QHelpEvent>
+#include <QPainter>
+#include <QToolTip>
+#include <cmath>
+
+static constexpr int WILDCARD_STRIP_HEIGHT = 12;
+static constexpr int AXIS_MARGIN = 24;
+
+HeatMapWidget::HeatMapWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    setMouseTracking(true);
+    setMinimumSize(SigParser::HEATMAP_POSITIONS * 3 + AXIS_MARGIN, 256 + WILDCARD_STRIP_HEIGHT + AXIS_MARGIN);
+}
+
+void HeatMapWidget::setHistogram(const SigParser::BytePositionHistogram &hist)
+{
+    m_hist = hist;
+    m_hasHist = true;
+    m_logMax = std::log1p(static_cast<double>(hist.maxCount()));
+    update();
+}
+
+void HeatMapWidget::clear()
+{
+    m_hist = SigParser::BytePositionHistogram();
+    m_hasHist = false;
+    m_logMax = 0.0;
+    update();
+}
+
+QSize HeatMapWidget::sizeHint() const
+{
+    return QSize(SigParser::HEATMAP_POSITIONS * 6 + AXIS_MARGIN, 512 + WILDCARD_STRIP_HEIGHT + AXIS_MARGIN);
+}
+
+QRect HeatMapWidget::wildcardRect() const
+{
+    return QRect(AXIS_MARGIN, 0, width() - AXIS_MARGIN, WILDCARD_STRIP_HEIGHT);
+}
+
+QRect HeatMapWidget::gridRect() const
+{
+    return QRect(AXIS_MARGIN, WILDCARD_STRIP_HEIGHT + 2, width() - AXIS_MARGIN,
+                 height() - WILDCARD_STRIP_HEIGHT - 2 - AXIS_MARGIN);
+}
+
+bool HeatMapWidget::cellAt(const QPoint &pt, int &position, int &byte) const
+{
+    const QRect wr = wildcardRect();
+    const QRect gr = gridRect();
+    if (pt.x() < gr.left() || pt.x() > gr.right()) return false;
+    position = (pt.x() - gr.left()) * SigParser::HEATMAP_POSITIONS / qMax(1, gr.width());
+    if (wr.contains(pt)) {
+        byte = -1;
+        return true;
+    }
+    if (!gr.contains(pt)) return false;
+    byte = (pt.y() - gr.top()) * 256 / qMax(1, gr.height());
+    return byte >= 0 && byte < 256;
+}
+
+void HeatMapWidget::paintEvent(QPaintEvent *)
+{
+    QPainter p(this);
+    p.fillRect(rect(), palette().color(QPalette::Base));
+    if (!m_hasHist || m_hist.moduleCount == 0) {
+        p.setPen(palette().color(QPalette::PlaceholderText));
+        p.drawText(rect(), Qt::AlignCenter, tr("No signature loaded"));
+        return;
+    }
+
+    const QRect gr = gridRect();
+    const QRect wr = wildcardRect();
+    const double colW = static_cast<double>(gr.width()) / SigParser::HEATMAP_POSITIONS;
+    const double rowH = static_cast<double>(gr.height()) / 256;
+    for (int pos = 0; pos < SigParser::HEATMAP_POSITIONS; ++pos) {
+        const int x0 = gr.left() + static_cast<int>(pos * colW);
+        const int x1 = gr.left() + static_cast<int>((pos + 1) * colW);
+        const int wildShade = 255 - static_cast<int>(m_hist.wildcardRate(pos) * 255);
+        p.fillRect(QRect(x0, wr.top(), x1 - x0, wr.height()), QColor(255, wildShade, wildShade));
+        for (int b = 0; b < 256; ++b) {
+            const quint64 n = m_hist.count(pos, b);
+            if (!n) continue;
+            // Log scale so rare literals stay visible next to 0x00/0xFF peaks
+            const double t = m_logMax > 0 ? std::log1p(static_cast<double>(n)) / m_logMax : 0.0;
+            const QColor c = QColor::fromHsvF(0.66 * (1.0 - t), 1.0, 0.4 + 0.6 * t);
+            const int y0 = gr.top() + static_cast<int>(b * rowH);
+            const int y1 = gr.top() + static_cast<int>((b + 1) * rowH);
+            p.fillRect(QRect(x0, y0, x1 - x0, qMax(1, y1 - y0)), c);
+        }
+    }
+
+    p.setPen(palette().color(QPalette::WindowText));
+    for (int b = 0; b < 256; b += 0x40) {
+        const int y = gr.top() + static_cast<int>(b * rowH);
+        p.drawText(QRect(0, y, AXIS_MARGIN - 2, 14), Qt::AlignRight | Qt::AlignTop, QString("%1").arg(b, 2, 16, QChar('0')).toUpper());
+    }
+    for (int pos = 0; pos < SigParser::HEATMAP_POSITIONS; pos += 8) {
+        const int x = gr.left() + static_cast<int>(pos * colW);
+        p.drawText(QRect(x, gr.bottom() + 2, 30, AXIS_MARGIN - 2), Qt::AlignLeft | Qt::AlignTop, QString::number(pos));
+    }
+}
+
+bool HeatMapWidget::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip) {
+        QHelpEvent *help = static_cast<QHelpEvent *>(event);
+        int pos = 0;
+        int byte = 0;
+        if (m_hasHist && cellAt(help->pos(), pos, byte)) {
+            QString text;
+            if (byte < 0) {
+                text = tr("Position %1: %2% wildcard (%3 of %4 modules)")
+                           .arg(pos).arg(m_hist.wildcardRate(pos) * 100.0, 0, 'f', 1)
+                           .arg(m_hist.wildcards[pos]).arg(m_hist.covered[pos]);
+            } else {
+                text = tr("Position %1, byte %2: %3 modules")
+                           .arg(pos).arg(byte, 2, 16, QChar('0')).arg(m_hist.count(pos, byte));
+            }
+            QToolTip::showText(help->globalPos(), text, this);
+        } else {
+            QToolTip::hideText();
+            event->ignore();
+        }
+        return true;
+    }
+    return QWidget::event(event);
+}
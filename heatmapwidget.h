@@ -0,0 +1,34 @@
+#ifndef HEATMAPWIDGET_H
+#define HEATMAPWIDGET_H
+
+#include <QWidget>
+#include "sigparser/flirtheatmap.h"
+
+// Pattern position (x) by byte value (y) heat map, with a wildcard-rate strip on top
+class HeatMapWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit HeatMapWidget(QWidget *parent = nullptr);
+
+    void setHistogram(const SigParser::BytePositionHistogram &hist);
+    void clear();
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    bool event(QEvent *event) override;
+
+private:
+    QRect gridRect() const;
+    QRect wildcardRect() const;
+    bool cellAt(const QPoint &pt, int &position, int &byte) const;
+
+    SigParser::BytePositionHistogram m_hist;
+    bool m_hasHist = false;
+    double m_logMax = 0.0;
+};
+
+#endif // HEATMAPWIDGET_H
@@ -0,0 +1,125 @@
+#include "hexviewwidget.h"
+#include <QFontDatabase>
+#include <QPainter>
+#include <QScrollBar>
+
+static constexpr int BYTES_PER_ROW = 16;
+static constexpr int OFFSET_CHARS = 10;  // 8 hex digits + 2 spaces
+static constexpr int ASCII_GAP_CHARS = 1;
+
+HexViewWidget::HexViewWidget(QWidget *parent)
+    : QAbstractScrollArea(parent)
+{
+    QFont font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    viewport()->setFont(font);
+    setFont(font);
+    m_charWidth = fontMetrics().horizontalAdvance('0');
+    updateScrollBars();
+}
+
+void HexViewWidget::setData(const QByteArray &data)
+{
+    m_data = data;
+    m_highlights.clear();
+    verticalScrollBar()->setValue(0);
+    updateScrollBars();
+    viewport()->update();
+}
+
+void HexViewWidget::setHighlights(const QVector<Highlight> &highlights)
+{
+    m_highlights = highlights;
+    viewport()->update();
+}
+
+void HexViewWidget::scrollToOffset(qsizetype offset)
+{
+    if (offset < 0 || offset >= m_data.size()) return;
+    const qsizetype row = offset / BYTES_PER_ROW;
+    const int first = verticalScrollBar()->value();
+    const int visible = qMax(1, viewport()->height() / rowHeight());
+    if (row < first || row >= first + visible)
+        verticalScrollBar()->setValue(static_cast<int>(qMax<qsizetype>(0, row - 2)));
+}
+
+qsizetype HexViewWidget::rowCount() const
+{
+    return (m_data.size() + BYTES_PER_ROW - 1) / BYTES_PER_ROW;
+}
+
+int HexViewWidget::rowHeight() const
+{
+    return fontMetrics().height();
+}
+
+void HexViewWidget::updateScrollBars()
+{
+    const int visible = qMax(1, viewport()->height() / rowHeight());
+    verticalScrollBar()->setRange(0, static_cast<int>(qMax<qsizetype>(0, rowCount() - visible)));
+    verticalScrollBar()->setPageStep(visible);
+    verticalScrollBar()->setSingleStep(1);
+    const int contentWidth = (OFFSET_CHARS + BYTES_PER_ROW * 3 + ASCII_GAP_CHARS + BYTES_PER_ROW) * m_charWidth;
+    horizontalScrollBar()->setRange(0, qMax(0, contentWidth - viewport()->width()));
+    horizontalScrollBar()->setPageStep(viewport()->width());
+}
+
+void HexViewWidget::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+}
+
+QColor HexViewWidget::highlightFor(qsizetype offset) const
+{
+    for (int i = m_highlights.size() - 1; i >= 0; --i) {
+        if (offset >= m_highlights[i].begin && offset < m_highlights[i].end)
+            return m_highlights[i].color;
+    }
+    return QColor();
+}
+
+void HexViewWidget::paintEvent(QPaintEvent *)
+{
+    QPainter p(viewport());
+    p.fillRect(viewport()->rect(), palette().color(QPalette::Base));
+    if (m_data.isEmpty()) return;
+
+    const int rh = rowHeight();
+    const int ascent = fontMetrics().ascent();
+    const int xShift = -horizontalScrollBar()->value();
+    const int hexLeft = xShift + OFFSET_CHARS * m_charWidth;
+    const int asciiLeft = hexLeft + (BYTES_PER_ROW * 3 + ASCII_GAP_CHARS) * m_charWidth;
+    const QColor textColor = palette().color(QPalette::Text);
+    const QColor offsetColor = palette().color(QPalette::PlaceholderText);
+    const uchar *bytes = reinterpret_cast<const uchar *>(m_data.constData());
+    static const char hexDigits[] = "0123456789ABCDEF";
+
+    const qsizetype firstRow = verticalScrollBar()->value();
+    const qsizetype lastRow = qMin(rowCount(), firstRow + viewport()->height() / rh + 1);
+    for (qsizetype row = firstRow; row < lastRow; ++row) {
+        const int y = static_cast<int>(row - firstRow) * rh;
+        const qsizetype base = row * BYTES_PER_ROW;
+        const int n = static_cast<int>(qMin<qsizetype>(BYTES_PER_ROW, m_data.size() - base));
+
+        p.setPen(offsetColor);
+        p.drawText(xShift, y + ascent, QString("%1").arg(base, 8, 16, QChar('0')).toUpper());
+
+        char hex[BYTES_PER_ROW * 3];
+        char ascii[BYTES_PER_ROW];
+        for (int i = 0; i < n; ++i) {
+            const uchar b = bytes[base + i];
+            hex[i * 3] = hexDigits[b >> 4];
+            hex[i * 3 + 1] = hexDigits[b & 0xf];
+            hex[i * 3 + 2] = ' ';
+            ascii[i] = (b >= 0x20 && b < 0x7f) ? static_cast<char>(b) : '.';
+            const QColor hl = highlightFor(base + i);
+            if (hl.isValid()) {
+                p.fillRect(hexLeft + i * 3 * m_charWidth, y, 2 * m_charWidth, rh, hl);
+                p.fillRect(asciiLeft + i * m_charWidth, y, m_charWidth, rh, hl);
+            }
+        }
+        p.setPen(textColor);
+        p.drawText(hexLeft, y + ascent, QString::fromLatin1(hex, n * 3));
+        p.drawText(asciiLeft, y + ascent, QString::fromLatin1(ascii, n));
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef HEXVIEWWIDGET_H
+#define HEXVIEWWIDGET_H
+
+#include <QAbstractScrollArea>
+#include <QByteArray>
+#include <QColor>
+#include <QVector>
+
+// Read-only hex dump that only lays out the rows in the viewport, so its cost does not
+// depend on the size of the data. Byte ranges can be highlighted to annotate the dump.
+class HexViewWidget : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    struct Highlight {
+        qsizetype begin = 0;
+        qsizetype end = 0;  // exclusive
+        QColor color;
+    };
+
+    explicit HexViewWidget(QWidget *parent = nullptr);
+
+    void setData(const QByteArray &data);
+    void setHighlights(const QVector<Highlight> &highlights);
+    /** Scroll so that offset is visible, placing it near the top when it is off screen. */
+    void scrollToOffset(qsizetype offset);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    void updateScrollBars();
+    qsizetype rowCount() const;
+    int rowHeight() const;
+    QColor highlightFor(qsizetype offset) const;
+
+    QByteArray m_data;
+    QVector<Highlight> m_highlights;  // later entries paint over earlier ones
+    int m_charWidth = 0;
+};
+
+#endif // HEXVIEWWIDGET_H
@@ -0,0 +1,307 @@
+#include "identifywidget.h"
+#include <QDoubleSpinBox>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QFontDatabase>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QStringList>
+#include <QTimer>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtConcurrent/QtConcurrentRun>
+#include "sigparser/matchconfidence.h"
+#include "sigparser/sigcatalogue.h"
+
+static constexpr int IDENTIFY_DELAY_MS = 150;
+// Near-misses listed per signature; full matches are always listed
+static constexpr int IDENTIFY_MAX_NEAR_MISSES = 200;
+// Fixed pattern bytes a module may miss by and still be listed as similar
+static constexpr int IDENTIFY_MAX_PATTERN_MISMATCHES = 2;
+
+IdentifyWidget::IdentifyWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    m_bytesEdit = new QPlainTextEdit();
+    m_bytesEdit->setPlaceholderText(tr("Paste the function's bytes (hex or hex dump), starting at its entry point"));
+    m_bytesEdit->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    layout->addWidget(m_bytesEdit, 1);
+
+    QHBoxLayout *buttons = new QHBoxLayout();
+    QPushButton *addButton = new QPushButton(tr("Add signatures..."));
+    QPushButton *binaryButton = new QPushButton(tr("Add for binary..."));
+    binaryButton->setToolTip(tr("Pick a binary and a signature folder; only signatures whose header fits "
+                                "the binary's format, architecture and bitness are added"));
+    QPushButton *clearButton = new QPushButton(tr("Remove added"));
+    m_sourcesLabel = new QLabel();
+    buttons->addWidget(addButton);
+    buttons->addWidget(binaryButton);
+    buttons->addWidget(clearButton);
+    buttons->addWidget(m_sourcesLabel, 1);
+    m_confidenceSpin = new QDoubleSpinBox();
+    m_confidenceSpin->setRange(0.0, 1.0);
+    m_confidenceSpin->setSingleStep(0.05);
+    m_confidenceSpin->setDecimals(2);
+    m_confidenceSpin->setPrefix(tr("Min confidence "));
+    m_confidenceSpin->setToolTip(tr("Hide matches resting on little evidence (few fixed bytes, no CRC, collisions)"));
+    buttons->addWidget(m_confidenceSpin);
+    layout->addLayout(buttons);
+
+    m_resultsTree = new QTreeWidget();
+    m_resultsTree->setHeaderLabels({ tr("Result"), tr("Signature"), tr("Module"), tr("Confidence"), tr("Functions") });
+    m_resultsTree->setRootIsDecorated(false);
+    m_resultsTree->setUniformRowHeights(true);
+    m_resultsTree->header()->setStretchLastSection(true);
+    layout->addWidget(m_resultsTree, 2);
+
+    m_identifyTimer = new QTimer(this);
+    m_identifyTimer->setSingleShot(true);
+    m_identifyTimer->setInterval(IDENTIFY_DELAY_MS);
+    connect(m_identifyTimer, &QTimer::timeout, this, &IdentifyWidget::identify);
+    connect(m_bytesEdit, &QPlainTextEdit::textChanged, m_identifyTimer, qOverload<>(&QTimer::start));
+    connect(addButton, &QPushButton::clicked, this, &IdentifyWidget::onAddSignatures);
+    connect(m_confidenceSpin, &QDoubleSpinBox::valueChanged, m_identifyTimer, qOverload<>(&QTimer::start));
+    connect(binaryButton, &QPushButton::clicked, this, &IdentifyWidget::onAddForBinary);
+    connect(clearButton, &QPushButton::clicked, this, &IdentifyWidget::onClearSignatures);
+    connect(&m_loadWatcher, &QFutureWatcher<Source>::finished, this, &IdentifyWidget::onSignaturesLoaded);
+    connect(&m_identifyWatcher, &QFutureWatcher<Outcome>::finished, this, &IdentifyWidget::onIdentifyFinished);
+    updateSourcesLabel();
+}
+
+IdentifyWidget::~IdentifyWidget()
+{
+    m_loadWatcher.cancel();
+    m_loadWatcher.waitForFinished();
+    m_identifyWatcher.waitForFinished();
+}
+
+void IdentifyWidget::setPrimarySignature(const QString &name, const SigParser::FlirtResult &result)
+{
+    m_primary = Source();
+    m_primaryResult = SigParser::FlirtResult();
+    ++m_primaryGeneration;
+    if (result.success) {
+        m_primary.name = name.isEmpty() ? tr("Open signature") : name;
+        m_primaryResult = result;
+    }
+    updateSourcesLabel();
+    m_identifyTimer->start();
+}
+
+void IdentifyWidget::ensurePrimaryMatcher()
+{
+    if (m_primaryResult.success && !m_primary.matcher)
+        m_primary.matcher = std::make_shared<const SigParser::FlirtMatcher>(SigParser::FlirtMatcher::compile(m_primaryResult));
+}
+
+double IdentifyWidget::minConfidence() const
+{
+    return m_confidenceSpin->value();
+}
+
+QVector<SigParser::CorpusSignature> IdentifyWidget::compiledSignatures()
+{
+    ensurePrimaryMatcher();
+    QVector<SigParser::CorpusSignature> out;
+    if (m_primary.matcher) out.append({ m_primary.name, m_primary.matcher });
+    for (const Source &s : m_extra)
+        out.append({ s.name, s.matcher });
+    return out;
+}
+
+void IdentifyWidget::updateSourcesLabel()
+{
+    const int count = (m_primaryResult.success ? 1 : 0) + m_extra.size();
+    m_sourcesLabel->setText(m_loadWatcher.isRunning() ? tr("Loading signatures...")
+                                                      : tr("%n signature(s)", nullptr, count));
+}
+
+void IdentifyWidget::onAddSignatures()
+{
+    if (m_loadWatcher.isRunning()) return;
+    const QStringList paths = QFileDialog::getOpenFileNames(this, tr("Add signatures"), QString(),
+                                                            tr("FLIRT signatures (*.sig *.sig.gz);;All files (*)"));
+    if (paths.isEmpty()) return;
+    m_skipped.clear();
+    loadSignatures(paths);
+}
+
+void IdentifyWidget::onAddForBinary()
+{
+    if (m_loadWatcher.isRunning()) return;
+    const QString binaryPath = QFileDialog::getOpenFileName(this, tr("Binary to identify"));
+    if (binaryPath.isEmpty()) return;
+    QString error;
+    const SigParser::BinaryInfo binary = SigParser::probeBinaryFile(binaryPath, &error);
+    if (!binary.isValid()) {
+        m_sourcesLabel->setText(error);
+        return;
+    }
+    const QString dir = QFileDialog::getExistingDirectory(this, tr("Signature folder"));
+    if (dir.isEmpty()) return;
+
+    // Only headers are read here; the selected signatures are parsed and compiled in the background
+    const QVector<SigParser::CatalogueEntry> entries = SigParser::scanCatalogue(dir);
+    m_skipped.clear();
+    const QVector<int> selected = SigParser::selectSignatures(entries, binary, &m_skipped);
+    QStringList paths;
+    for (int i : selected)
+        paths << entries[i].path;
+    if (paths.isEmpty()) {
+        m_sourcesLabel->setText(tr("No signature in the folder fits %1").arg(binary.description));
+        m_sourcesLabel->setToolTip(m_skipped.join("\n"));
+        return;
+    }
+    loadSignatures(paths);
+}
+
+void IdentifyWidget::loadSignatures(const QStringList &paths)
+{
+    m_loadWatcher.setFuture(QtConcurrent::mapped(paths, [](const QString &path) {
+        Source s;
+        s.name = QFileInfo(path).fileName();
+        SigParser::FlirtParser parser;
+        const SigParser::FlirtResult result = parser.parseFile(path);
+        if (result.success)
+            s.matcher = std::make_shared<const SigParser::FlirtMatcher>(SigParser::FlirtMatcher::compile(result));
+        else
+            s.error = result.errorMessage;
+        return s;
+    }));
+    updateSourcesLabel();
+}
+
+void IdentifyWidget::onSignaturesLoaded()
+{
+    if (!m_loadWatcher.isCanceled()) {
+        QStringList errors;
+        for (const Source &s : m_loadWatcher.future().results()) {
+            if (s.matcher)
+                m_extra.append(s);
+            else
+                errors << s.name + ": " + s.error;
+        }
+        if (!m_skipped.isEmpty())
+            errors << tr("Skipped %n signature(s) that do not fit the binary:", nullptr, m_skipped.size()) << m_skipped;
+        m_sourcesLabel->setToolTip(errors.join("\n"));
+    }
+    updateSourcesLabel();
+    identify();
+}
+
+void IdentifyWidget::onClearSignatures()
+{
+    m_extra.clear();
+    m_skipped.clear();
+    m_sourcesLabel->setToolTip(QString());
+    updateSourcesLabel();
+    identify();
+}
+
+void IdentifyWidget::identify()
+{
+    if (m_identifyWatcher.isRunning()) {
+        m_identifyPending = true;
+        return;
+    }
+    m_identifyPending = false;
+    m_resultsTree->clear();
+    const QString text = m_bytesEdit->toPlainText();
+    if (text.trimmed().isEmpty()) return;
+    QString error;
+    const QByteArray data = SigParser::parseHexDump(text, &error);
+    if (data.isEmpty()) {
+        m_resultsTree->addTopLevelItem(new QTreeWidgetItem({ error }));
+        return;
+    }
+
+    // The open signature is compiled on the worker the first time; onIdentifyFinished() keeps it
+    Outcome job;
+    job.primaryGeneration = m_primaryGeneration;
+    job.sources = m_extra;
+    const SigParser::FlirtResult primaryResult = m_primary.matcher ? SigParser::FlirtResult() : m_primaryResult;
+    const Source primary = m_primary;
+    m_identifyWatcher.setFuture(QtConcurrent::run([job, primary, primaryResult, data]() mutable {
+        Source first = primary;
+        if (!first.matcher && primaryResult.success) {
+            first.matcher = std::make_shared<const SigParser::FlirtMatcher>(SigParser::FlirtMatcher::compile(primaryResult));
+            job.primaryMatcher = first.matcher;
+        }
+        if (first.matcher) job.sources.prepend(first);
+        job.dataSize = data.size();
+        job.candidates = QtConcurrent::blockingMapped<QList<QVector<SigParser::FlirtMatcher::Candidate>>>(
+            job.sources, [&data](const Source &s) { return s.matcher->match(data); });
+        job.patternMisses = QtConcurrent::blockingMapped<QList<QVector<SigParser::FlirtMatcher::PatternMiss>>>(
+            job.sources, [&data](const Source &s) {
+                return s.matcher->patternNearMisses(data, IDENTIFY_MAX_PATTERN_MISMATCHES, IDENTIFY_MAX_NEAR_MISSES);
+            });
+        return job;
+    }));
+}
+
+void IdentifyWidget::onIdentifyFinished()
+{
+    if (m_identifyPending) {
+        identify();
+        return;
+    }
+    const Outcome outcome = m_identifyWatcher.result();
+    if (outcome.primaryMatcher && outcome.primaryGeneration == m_primaryGeneration && !m_primary.matcher)
+        m_primary.matcher = outcome.primaryMatcher;
+
+    QList<QTreeWidgetItem *> matches;
+    QList<QTreeWidgetItem *> nearMisses;
+    const double threshold = minConfidence();
+    int belowThreshold = 0;
+    for (int si = 0; si < outcome.sources.size(); ++si) {
+        const Source &source = outcome.sources[si];
+        const SigParser::FlirtResult &result = source.matcher->result();
+        auto makeItem = [&](int module, const QString &status) {
+            const SigParser::FlirtModule &mod = result.modules[module];
+            // Pasted bytes have no surroundings, so references cannot be resolved
+            const SigParser::MatchEvidence evidence = SigParser::matchEvidence(mod);
+            QStringList names;
+            for (const SigParser::FlirtFunction &f : mod.publicFunctions)
+                names << f.name;
+            QTreeWidgetItem *item = new QTreeWidgetItem({
+                status, source.name, QString("#%1").arg(module),
+                QString::number(SigParser::matchConfidence(evidence), 'f', 2), names.join(", ") });
+            item->setToolTip(3, tr("%1 fixed bytes, CRC over %2 bytes, %3 tail bytes, %4 references%5")
+                                    .arg(evidence.fixedBytes).arg(evidence.crcLength).arg(evidence.tailBytes)
+                                    .arg(evidence.references)
+                                    .arg(evidence.collision ? tr(", name collision") : QString()));
+            item->setToolTip(4, mod.rulesSummary());
+            return item;
+        };
+        int misses = 0;
+        for (const SigParser::FlirtMatcher::Candidate &c : outcome.candidates[si]) {
+            const bool matched = c.failed == SigParser::FlirtMatcher::Check::None;
+            if (!matched && ++misses > IDENTIFY_MAX_NEAR_MISSES) continue;
+            if (matched && SigParser::matchConfidence(SigParser::matchEvidence(result.modules[c.module])) < threshold) {
+                ++belowThreshold;
+                continue;
+            }
+            (matched ? matches : nearMisses).append(makeItem(
+                c.module, matched ? tr("Match") : tr("Failed: %1").arg(SigParser::FlirtMatcher::checkName(c.failed))));
+        }
+        // Modules whose pattern is a byte or two off, which the trie walk never reaches
+        for (const SigParser::FlirtMatcher::PatternMiss &m : outcome.patternMisses[si]) {
+            if (++misses > IDENTIFY_MAX_NEAR_MISSES) break;
+            nearMisses.append(makeItem(m.module, tr("Failed: Pattern (%n byte(s), first at +%1)", nullptr, m.mismatches)
+                                                     .arg(m.firstMismatch, 0, 16)));
+        }
+    }
+    m_resultsTree->clear();
+    m_resultsTree->addTopLevelItems(matches);
+    m_resultsTree->addTopLevelItems(nearMisses);
+    if (belowThreshold > 0)
+        m_resultsTree->addTopLevelItem(new QTreeWidgetItem({ tr("%n match(es) below the confidence threshold hidden", nullptr, belowThreshold) }));
+    if (matches.isEmpty() && nearMisses.isEmpty() && belowThreshold == 0)
+        m_resultsTree->addTopLevelItem(new QTreeWidgetItem({ tr("No module pattern matches %n byte(s)", nullptr, outcome.dataSize) }));
+}
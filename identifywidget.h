@@ -0,0 +1,75 @@
+#ifndef IDENTIFYWIDGET_H
+#define IDENTIFYWIDGET_H
+
+#include <QFutureWatcher>
+#include <QWidget>
+#include <memory>
+#include "sigparser/corpusscan.h"
+
+class QDoubleSpinBox;
+class QLabel;
+class QPlainTextEdit;
+class QTimer;
+class QTreeWidget;
+
+// Paste the bytes of an unknown function and run the FLIRT checks against the open
+// signature plus any extra signatures added here
+class IdentifyWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit IdentifyWidget(QWidget *parent = nullptr);
+    ~IdentifyWidget() override;
+
+    /** Signature currently open in the main window; an unsuccessful result removes it. */
+    void setPrimarySignature(const QString &name, const SigParser::FlirtResult &result);
+    /** The open signature and the added ones, compiled, for scans elsewhere. */
+    QVector<SigParser::CorpusSignature> compiledSignatures();
+    /** Matches below this confidence are hidden here and dropped by scans started elsewhere. */
+    double minConfidence() const;
+
+private slots:
+    void identify();
+    void onAddSignatures();
+    void onAddForBinary();
+    void onClearSignatures();
+    void onSignaturesLoaded();
+    void onIdentifyFinished();
+
+private:
+    struct Source {
+        QString name;
+        QString error;
+        std::shared_ptr<const SigParser::FlirtMatcher> matcher;
+    };
+    // One identify run: compiled on and matched on a worker thread, shown by onIdentifyFinished()
+    struct Outcome {
+        quint64 primaryGeneration = 0;
+        std::shared_ptr<const SigParser::FlirtMatcher> primaryMatcher;  // compiled by this run, if any
+        QVector<Source> sources;
+        QList<QVector<SigParser::FlirtMatcher::Candidate>> candidates;  // per source
+        QList<QVector<SigParser::FlirtMatcher::PatternMiss>> patternMisses;  // per source
+        int dataSize = 0;
+    };
+
+    void loadSignatures(const QStringList &paths);
+    void ensurePrimaryMatcher();
+    void updateSourcesLabel();
+
+    Source m_primary;
+    SigParser::FlirtResult m_primaryResult;  // compiled on first use
+    quint64 m_primaryGeneration = 0;         // bumped whenever m_primaryResult changes
+    QVector<Source> m_extra;
+    QStringList m_skipped;  // catalogue signatures that do not fit the chosen binary
+    QFutureWatcher<Source> m_loadWatcher;
+    QFutureWatcher<Outcome> m_identifyWatcher;
+    bool m_identifyPending = false;  // input changed while a run was in flight
+    QPlainTextEdit *m_bytesEdit;
+    QLabel *m_sourcesLabel;
+    QDoubleSpinBox *m_confidenceSpin;
+    QTreeWidget *m_resultsTree;
+    QTimer *m_identifyTimer;
+};
+
+#endif // IDENTIFYWIDGET_H
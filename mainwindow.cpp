@@ -1,18 +1,66 @@
 #include "mainwindow.h"
 #include "./ui_mainwindow.h"
+#include "functionsmodel.h"
+#include "gotodialog.h"
+#include "heatmapwidget.h"
+#include "hexviewwidget.h"
+#include "identifywidget.h"
+#include "signaturedelegate.h"
+#include "statisticswidget.h"
+#include "sigparser/fuzzymatch.h"
+#include "sigparser/matchcache.h"
+#include "sigparser/patternsearch.h"
+#include "DockAreaWidget.h"
 #include <QHeaderView>
+#include <QAction>
 #include <QItemSelectionModel>
 #include <QDragEnterEvent>
+#include <QApplication>
+#include <QClipboard>
+#include <QComboBox>
+#include <QFileDialog>
 #include <QDropEvent>
-#include <QFile>
+#include <QFontDatabase>
 #include <QLineEdit>
 #include <QMessageBox>
 #include <QMimeData>
 #include <QUrl>
 #include <QGroupBox>
+#include <QHBoxLayout>
 #include <QPlainTextEdit>
-#include <QTableWidget>
+#include <QPointer>
+#include <QProgressBar>
+#include <QPromise>
+#include <QSaveFile>
+#include <QStringDecoder>
+#include <QToolButton>
+#include <QTableView>
 #include <QVBoxLayout>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
+
+// Fuzzy mode keeps this many best-scoring names
+static constexpr int FUZZY_MAX_RESULTS = 200;
+
+// Write-only device that decodes each chunk FunctionExportWriter flushes into one QString,
+// so a clipboard copy never holds the whole UTF-8 payload
+class Utf8DecodingDevice : public QIODevice
+{
+public:
+    explicit Utf8DecodingDevice(QString *out) : m_out(out) {}
+
+protected:
+    qint64 readData(char *, qint64) override { return -1; }
+    qint64 writeData(const char *data, qint64 len) override
+    {
+        m_out->append(m_decoder.decode(QByteArrayView(data, len)));
+        return len;
+    }
+
+private:
+    QString *m_out;
+    QStringDecoder m_decoder{ QStringDecoder::Utf8 };
+};
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -49,15 +97,32 @@ MainWindow::MainWindow(QWidget *parent)
     m_searchEdit = new QLineEdit();
     m_searchEdit->setPlaceholderText(tr("Search..."));
     m_searchEdit->setClearButtonEnabled(true);
-    funcGroupLayout->addWidget(m_searchEdit);
-    m_functionsTable = new QTableWidget();
-    m_functionsTable->setColumnCount(6);
+    m_searchModeCombo = new QComboBox();
+    m_searchModeCombo->addItem(tr("Contains"), SearchContains);
+    m_searchModeCombo->addItem(tr("Fuzzy"), SearchFuzzy);
+    m_searchModeCombo->addItem(tr("Bytes"), SearchBytes);
+    QHBoxLayout *searchLayout = new QHBoxLayout();
+    searchLayout->addWidget(m_searchEdit, 1);
+    searchLayout->addWidget(m_searchModeCombo);
+    funcGroupLayout->addLayout(searchLayout);
+    m_functionsModel = new FunctionsModel(this);
+    m_functionsProxy = new FunctionsFilterModel(this);
+    m_functionsProxy->setSourceModel(m_functionsModel);
+    m_functionsTable = new QTableView();
+    m_functionsTable->setModel(m_functionsProxy);
+    m_functionsTable->setItemDelegateForColumn(FunctionsModel::SignatureColumn, new SignatureDelegate(m_functionsModel, m_functionsTable));
     m_functionsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
-    m_functionsTable->setSelectionMode(QAbstractItemView::SingleSelection);
-    m_functionsTable->setHorizontalHeaderLabels({ tr("Module"), tr("Name"), tr("Offset"), tr("Local"), tr("Collision"), tr("Signature") });
+    m_functionsTable->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_functionsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_functionsTable->setWordWrap(false);
     m_functionsTable->horizontalHeader()->setStretchLastSection(true);
     m_functionsTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+    // Fixed row heights keep scrolling independent of row count
+    m_functionsTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    m_functionsTable->verticalHeader()->setDefaultSectionSize(m_functionsTable->fontMetrics().height() + 6);
+    m_functionsTable->verticalHeader()->hide();
     m_functionsTable->setSortingEnabled(true);
+    m_functionsTable->sortByColumn(-1, Qt::AscendingOrder);
     funcGroupLayout->addWidget(m_functionsTable);
     funcLayout->addWidget(funcGroup);
     ads::CDockWidget *functionsDock = m_dockManager->createDockWidget(tr("Functions"));
@@ -67,6 +132,8 @@ MainWindow::MainWindow(QWidget *parent)
     connect(m_functionsTable->selectionModel(), &QItemSelectionModel::selectionChanged,
             this, &MainWindow::onFunctionSelectionChanged);
     connect(m_searchEdit, &QLineEdit::textChanged, this, &MainWindow::onSearchTextChanged);
+    connect(m_searchModeCombo, &QComboBox::currentIndexChanged, this, &MainWindow::applyTableFilter);
+    connect(&m_loadWatcher, &QFutureWatcher<SigParser::FlirtResult>::finished, this, &MainWindow::onLoadFinished);
 
     // Detection rules dock
     QWidget *rulesWidget = new QWidget();
@@ -81,30 +148,232 @@ MainWindow::MainWindow(QWidget *parent)
     rulesLayout->addWidget(rulesGroup);
     ads::CDockWidget *rulesDock = m_dockManager->createDockWidget(tr("Detection rules"));
     rulesDock->setWidget(rulesWidget);
-    m_dockManager->addDockWidget(ads::RightDockWidgetArea, rulesDock);
+    auto *rightArea = m_dockManager->addDockWidget(ads::RightDockWidgetArea, rulesDock);
     ui->menuView->addAction(rulesDock->toggleViewAction());
+
+    // Statistics dock (computed lazily the first time it is shown for a result)
+    m_statisticsWidget = new StatisticsWidget();
+    m_statisticsDock = m_dockManager->createDockWidget(tr("Statistics"));
+    m_statisticsDock->setWidget(m_statisticsWidget);
+    m_dockManager->addDockWidgetTabToArea(m_statisticsDock, rightArea);
+    rightArea->setCurrentDockWidget(rulesDock);
+    ui->menuView->addAction(m_statisticsDock->toggleViewAction());
+    connect(m_statisticsDock, &ads::CDockWidget::visibilityChanged, this, [this](bool visible) {
+        if (visible) refreshStatistics();
+    });
+    connect(&m_statisticsWatcher, &QFutureWatcher<SigParser::FlirtStatistics>::finished,
+            this, &MainWindow::onStatisticsFinished);
+
+    // Byte heat map dock (lazy, like statistics)
+    m_heatMapWidget = new HeatMapWidget();
+    ads::CDockWidget *heatMapDock = m_dockManager->createDockWidget(tr("Byte heat map"));
+    heatMapDock->setWidget(m_heatMapWidget);
+    m_dockManager->addDockWidgetTabToArea(heatMapDock, rightArea);
+    rightArea->setCurrentDockWidget(rulesDock);
+    ui->menuView->addAction(heatMapDock->toggleViewAction());
+    connect(heatMapDock, &ads::CDockWidget::visibilityChanged, this, [this](bool visible) {
+        if (visible) refreshHeatMap();
+    });
+    connect(&m_heatMapWatcher, &QFutureWatcher<SigParser::BytePositionHistogram>::finished,
+            this, &MainWindow::onHeatMapFinished);
+
+    // Trie profile dock (lazy, like statistics)
+    m_trieProfileText = new QPlainTextEdit();
+    m_trieProfileText->setReadOnly(true);
+    m_trieProfileText->setLineWrapMode(QPlainTextEdit::NoWrap);
+    m_trieProfileText->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    ads::CDockWidget *trieProfileDock = m_dockManager->createDockWidget(tr("Trie profile"));
+    trieProfileDock->setWidget(m_trieProfileText);
+    m_dockManager->addDockWidgetTabToArea(trieProfileDock, rightArea);
+    rightArea->setCurrentDockWidget(rulesDock);
+    ui->menuView->addAction(trieProfileDock->toggleViewAction());
+    connect(trieProfileDock, &ads::CDockWidget::visibilityChanged, this, [this](bool visible) {
+        if (visible) refreshTrieProfile();
+    });
+    connect(&m_trieProfileWatcher, &QFutureWatcher<SigParser::TrieProfile>::finished,
+            this, &MainWindow::onTrieProfileFinished);
+
+    // Hex view of the parsed body, annotated with the selected module's bytes
+    m_hexView = new HexViewWidget();
+    ads::CDockWidget *hexDock = m_dockManager->createDockWidget(tr("Hex view"));
+    hexDock->setWidget(m_hexView);
+    m_dockManager->addDockWidgetTabToArea(hexDock, rightArea);
+    rightArea->setCurrentDockWidget(rulesDock);
+    ui->menuView->addAction(hexDock->toggleViewAction());
+
+    // Identify pasted function bytes against the open signature and any added ones
+    m_identifyWidget = new IdentifyWidget();
+    ads::CDockWidget *identifyDock = m_dockManager->createDockWidget(tr("Identify"));
+    identifyDock->setWidget(m_identifyWidget);
+    m_dockManager->addDockWidgetTabToArea(identifyDock, rightArea);
+    rightArea->setCurrentDockWidget(rulesDock);
+    ui->menuView->addAction(identifyDock->toggleViewAction());
+
+    // Go-to palette
+    m_gotoDialog = new GotoDialog(m_functionsModel, this);
+    connect(m_gotoDialog, &GotoDialog::functionChosen, this, &MainWindow::selectFunctionRow);
+    ui->menuView->addSeparator();
+    QAction *gotoAction = ui->menuView->addAction(tr("Go to..."));
+    gotoAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_G));
+    connect(gotoAction, &QAction::triggered, this, &MainWindow::onGotoRequested);
+
+    // Export and copy of the filtered rows run in the background
+    QAction *exportAction = ui->menuFile->addAction(tr("Export visible rows..."));
+    connect(exportAction, &QAction::triggered, this, &MainWindow::onExportVisibleRows);
+    QAction *copyAction = new QAction(tr("Copy selection"), m_functionsTable);
+    copyAction->setShortcut(QKeySequence::Copy);
+    copyAction->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+    connect(copyAction, &QAction::triggered, this, &MainWindow::onCopySelection);
+    QAction *corpusAction = ui->menuFile->addAction(tr("Scan corpus..."));
+    corpusAction->setToolTip(tr("Run the Identify signatures over every binary in a folder, writing NDJSON"));
+    connect(corpusAction, &QAction::triggered, this, &MainWindow::onScanCorpus);
+    m_functionsTable->addAction(copyAction);
+    m_functionsTable->addAction(exportAction);
+    m_functionsTable->setContextMenuPolicy(Qt::ActionsContextMenu);
+    m_exportProgress = new QProgressBar();
+    m_exportProgress->setMaximumWidth(200);
+    m_exportProgress->hide();
+    m_exportCancel = new QToolButton();
+    m_exportCancel->setText(tr("Cancel"));
+    m_exportCancel->hide();
+    statusBar()->addPermanentWidget(m_exportProgress);
+    statusBar()->addPermanentWidget(m_exportCancel);
+    connect(m_exportCancel, &QToolButton::clicked, this, [this]() {
+        m_exportWatcher.cancel();
+        if (m_corpusStop) *m_corpusStop = true;
+    });
+    connect(&m_exportWatcher, &QFutureWatcher<QString>::progressValueChanged, m_exportProgress, &QProgressBar::setValue);
+    connect(&m_exportWatcher, &QFutureWatcher<QString>::finished, this, &MainWindow::onExportFinished);
+    connect(&m_corpusWatcher, &QFutureWatcher<SigParser::CorpusStats>::progressRangeChanged, m_exportProgress, &QProgressBar::setRange);
+    connect(&m_corpusWatcher, &QFutureWatcher<SigParser::CorpusStats>::progressValueChanged, m_exportProgress, &QProgressBar::setValue);
+    connect(&m_corpusWatcher, &QFutureWatcher<SigParser::CorpusStats>::progressTextChanged, this,
+            [this](const QString &text) { statusBar()->showMessage(text); });
+    connect(&m_corpusWatcher, &QFutureWatcher<SigParser::CorpusStats>::finished, this, &MainWindow::onCorpusScanFinished);
 }
 
 MainWindow::~MainWindow()
 {
+    m_exportWatcher.cancel();
+    m_exportWatcher.waitForFinished();
+    if (m_corpusStop) *m_corpusStop = true;
+    m_corpusWatcher.waitForFinished();
+    m_loadWatcher.cancel();
+    m_loadWatcher.waitForFinished();
+    for (QFuture<SigParser::FlirtResult> &load : m_supersededLoads)
+        load.waitForFinished();
+    m_statisticsWatcher.waitForFinished();
+    m_heatMapWatcher.waitForFinished();
+    m_trieProfileWatcher.waitForFinished();
     delete ui;
 }
 
 void MainWindow::setSigResult(const SigParser::FlirtResult &result)
 {
     m_result = result;
+    m_statisticsValid = false;
+    m_statisticsWatcher.setFuture(QFuture<SigParser::FlirtStatistics>());
+    m_heatMapValid = false;
+    m_heatMapWatcher.setFuture(QFuture<SigParser::BytePositionHistogram>());
+    m_trieProfileValid = false;
+    m_trieProfileWatcher.setFuture(QFuture<SigParser::TrieProfile>());
+    m_functionIndex.reset();
+    m_gotoDialog->setIndex(nullptr);
     refreshLibraryInfo();
+    m_hexView->setData(m_result.body);
+    m_identifyWidget->setPrimarySignature(m_result.libraryName, m_result);
     refreshFunctionsTable();
     refreshRulesForSelection();
+    refreshHexSelection();
+    refreshStatistics();
+    refreshHeatMap();
+    refreshTrieProfile();
 }
 
 void MainWindow::clearSig()
 {
     m_result = SigParser::FlirtResult();
     m_result.success = false;
+    m_statisticsValid = false;
+    m_statisticsWatcher.setFuture(QFuture<SigParser::FlirtStatistics>());
+    m_heatMapValid = false;
+    m_heatMapWatcher.setFuture(QFuture<SigParser::BytePositionHistogram>());
+    m_trieProfileValid = false;
+    m_trieProfileWatcher.setFuture(QFuture<SigParser::TrieProfile>());
+    m_functionIndex.reset();
+    m_gotoDialog->setIndex(nullptr);
     refreshLibraryInfo();
+    m_hexView->setData(m_result.body);
+    m_identifyWidget->setPrimarySignature(m_result.libraryName, m_result);
     refreshFunctionsTable();
     refreshRulesForSelection();
+    refreshHexSelection();
+    refreshStatistics();
+    refreshHeatMap();
+    refreshTrieProfile();
+}
+
+void MainWindow::refreshStatistics()
+{
+    if (!m_result.success) {
+        m_statisticsWidget->clear();
+        return;
+    }
+    if (m_statisticsValid || m_statisticsWatcher.isRunning() || !m_statisticsWidget->isVisible())
+        return;
+    m_statisticsWidget->setBusy();
+    // The copy shares the parsed data implicitly; the worker only reads it
+    m_statisticsWatcher.setFuture(QtConcurrent::run([result = m_result]() {
+        return SigParser::computeStatistics(result);
+    }));
+}
+
+void MainWindow::onStatisticsFinished()
+{
+    if (m_statisticsWatcher.isCanceled()) return;
+    m_statisticsWidget->setStatistics(m_statisticsWatcher.result());
+    m_statisticsValid = true;
+}
+
+void MainWindow::refreshHeatMap()
+{
+    if (!m_result.success) {
+        m_heatMapWidget->clear();
+        return;
+    }
+    if (m_heatMapValid || m_heatMapWatcher.isRunning() || !m_heatMapWidget->isVisible())
+        return;
+    m_heatMapWidget->clear();
+    m_heatMapWatcher.setFuture(QtConcurrent::run([result = m_result]() {
+        return SigParser::computeBytePositionHistogram(result);
+    }));
+}
+
+void MainWindow::onHeatMapFinished()
+{
+    if (m_heatMapWatcher.isCanceled()) return;
+    m_heatMapWidget->setHistogram(m_heatMapWatcher.result());
+    m_heatMapValid = true;
+}
+
+void MainWindow::refreshTrieProfile()
+{
+    if (!m_result.success) {
+        m_trieProfileText->setPlainText(QString());
+        return;
+    }
+    if (m_trieProfileValid || m_trieProfileWatcher.isRunning() || !m_trieProfileText->isVisible())
+        return;
+    m_trieProfileText->setPlainText(tr("Computing..."));
+    m_trieProfileWatcher.setFuture(QtConcurrent::run([result = m_result]() {
+        return SigParser::computeTrieProfile(result);
+    }));
+}
+
+void MainWindow::onTrieProfileFinished()
+{
+    if (m_trieProfileWatcher.isCanceled()) return;
+    m_trieProfileText->setPlainText(m_trieProfileWatcher.result().toText());
+    m_trieProfileValid = true;
 }
 
 void MainWindow::refreshLibraryInfo()
@@ -129,53 +398,71 @@ void MainWindow::refreshLibraryInfo()
 
 void MainWindow::refreshFunctionsTable()
 {
-    QTableWidget *t = m_functionsTable;
-    t->setSortingEnabled(false);
-    t->setRowCount(0);
-    if (!m_result.success) {
-        t->setSortingEnabled(true);
-        return;
-    }
-    QVector<SigParser::FlirtResult::FunctionEntry> entries = m_result.allFunctions();
-    t->setRowCount(entries.size());
-    for (int row = 0; row < entries.size(); ++row) {
-        const auto &e = entries[row];
-        auto setReadOnly = [t](int r, int c, QTableWidgetItem *item) {
-            item->setFlags(item->flags() & ~Qt::ItemIsEditable);
-            t->setItem(r, c, item);
-        };
-        QTableWidgetItem *moduleItem = new QTableWidgetItem(QString::number(e.moduleIndex));
-        moduleItem->setData(Qt::UserRole, row);
-        setReadOnly(row, 0, moduleItem);
-        setReadOnly(row, 1, new QTableWidgetItem(e.function->name));
-        setReadOnly(row, 2, new QTableWidgetItem(QString("0x%1").arg(e.function->offset, 0, 16)));
-        setReadOnly(row, 3, new QTableWidgetItem(e.function->isLocal ? "Y" : ""));
-        setReadOnly(row, 4, new QTableWidgetItem(e.function->isCollision ? "!" : ""));
-        setReadOnly(row, 5, new QTableWidgetItem(e.module->patternPathHex()));
-    }
-    t->setSortingEnabled(true);
+    if (!m_result.success)
+        m_functionsModel->clear();
+    else
+        m_functionsModel->setResult(m_result);
     applyTableFilter();
 }
 
 void MainWindow::applyTableFilter()
 {
     const QString text = m_searchEdit->text().trimmed();
-    QTableWidget *t = m_functionsTable;
-    for (int row = 0; row < t->rowCount(); ++row) {
-        if (text.isEmpty()) {
-            t->setRowHidden(row, false);
-            continue;
+    const int mode = m_searchModeCombo->currentData().toInt();
+    if (mode == SearchFuzzy && !text.isEmpty() && m_result.success) {
+        const SigParser::FunctionIndex &index = ensureFunctionIndex();
+        const QVector<SigParser::FuzzyHit> hits = SigParser::fuzzyFindNames(index, text, FUZZY_MAX_RESULTS);
+        QHash<int, int> rank;
+        for (const SigParser::FuzzyHit &hit : hits) {
+            for (int ordinal : index.functionsOfName(hit.nameId))
+                rank.insert(ordinal, rank.size());
         }
-        bool match = false;
-        for (int col = 0; col < t->columnCount(); ++col) {
-            QTableWidgetItem *item = t->item(row, col);
-            if (item && item->text().contains(text, Qt::CaseInsensitive)) {
-                match = true;
-                break;
+        m_functionsProxy->setRankedRows(rank);
+        m_functionsTable->sortByColumn(FunctionsModel::NameColumn, Qt::AscendingOrder);
+        return;
+    }
+    if (mode == SearchBytes && !text.isEmpty() && m_result.success) {
+        SigParser::BytePattern pattern;
+        QString error;
+        QHash<int, int> rank;
+        if (SigParser::parseBytePattern(text, pattern, &error)) {
+            const SigParser::FunctionIndex &index = ensureFunctionIndex();
+            const QVector<int> modules = SigParser::findModulesByPattern(m_result, pattern, m_result.modules.size());
+            for (int module : modules) {
+                for (int ordinal : index.functionsOfModule(module))
+                    rank.insert(ordinal, rank.size());
             }
+            statusBar()->showMessage(tr("%1 modules match the byte pattern").arg(modules.size()), 5000);
+        } else {
+            statusBar()->showMessage(error, 5000);
         }
-        t->setRowHidden(row, !match);
+        m_functionsProxy->setRankedRows(rank);
+        m_functionsTable->sortByColumn(FunctionsModel::NameColumn, Qt::AscendingOrder);
+        return;
+    }
+    if (!text.isEmpty() && m_result.success) {
+        // Names are matched in bulk over the index's Latin-1 arena; the proxy only checks the other columns
+        const SigParser::FunctionIndex &index = ensureFunctionIndex();
+        QBitArray nameMatches(index.functionCount());
+        for (int nameId : index.findNamesContaining(text)) {
+            for (int ordinal : index.functionsOfName(nameId))
+                nameMatches.setBit(ordinal);
+        }
+        m_functionsProxy->setFilterText(text, nameMatches);
+        return;
     }
+    m_functionsProxy->setFilterText(text);
+}
+
+const SigParser::FunctionIndex &MainWindow::ensureFunctionIndex()
+{
+    if (!m_functionIndex) {
+        QApplication::setOverrideCursor(Qt::WaitCursor);
+        m_functionIndex = std::make_shared<const SigParser::FunctionIndex>(SigParser::FunctionIndex::build(m_result));
+        QApplication::restoreOverrideCursor();
+        m_gotoDialog->setIndex(m_functionIndex);
+    }
+    return *m_functionIndex;
 }
 
 void MainWindow::onSearchTextChanged(const QString &)
@@ -183,29 +470,22 @@ void MainWindow::onSearchTextChanged(const QString &)
     applyTableFilter();
 }
 
+SigParser::FlirtResult::FunctionEntry MainWindow::currentFunctionEntry() const
+{
+    const QModelIndex current = m_functionsTable->currentIndex();
+    if (!current.isValid() || !m_result.success) return SigParser::FlirtResult::FunctionEntry();
+    return m_functionsModel->entry(m_functionsProxy->mapToSource(current).row());
+}
+
 void MainWindow::refreshRulesForSelection()
 {
-    int row = m_functionsTable->currentRow();
-    if (row < 0 || !m_result.success) {
-        m_rulesText->setPlainText(QString());
-        m_rulesText->setPlaceholderText("Select a function or module to view rules");
-        return;
-    }
-    QTableWidgetItem *item = m_functionsTable->item(row, 0);
-    if (!item) {
-        m_rulesText->setPlainText(QString());
-        m_rulesText->setPlaceholderText("Select a function or module to view rules");
-        return;
-    }
-    int originalIndex = item->data(Qt::UserRole).toInt();
-    QVector<SigParser::FlirtResult::FunctionEntry> entries = m_result.allFunctions();
-    if (originalIndex < 0 || originalIndex >= entries.size()) {
+    const SigParser::FlirtResult::FunctionEntry e = currentFunctionEntry();
+    if (!e.module) {
         m_rulesText->setPlainText(QString());
         m_rulesText->setPlaceholderText("Select a function or module to view rules");
         return;
     }
     m_rulesText->setPlaceholderText(QString());
-    const auto &e = entries[originalIndex];
     QStringList lines;
     lines << "Function: " + e.function->name;
     lines << "Pattern path: " + e.module->patternPathHex();
@@ -213,9 +493,197 @@ void MainWindow::refreshRulesForSelection()
     m_rulesText->setPlainText(lines.join("\n\n"));
 }
 
+void MainWindow::refreshHexSelection()
+{
+    const SigParser::FlirtResult::FunctionEntry e = currentFunctionEntry();
+    if (!e.module || e.module->bodyBegin < 0) {
+        m_hexView->setHighlights({});
+        return;
+    }
+    QVector<HexViewWidget::Highlight> highlights;
+    // Pattern nodes from the root down to the module's leaf, then the module record itself
+    for (int n = e.module->leafNode; n > 0; n = m_result.nodes[n].parent) {
+        const SigParser::FlirtTreeNode &node = m_result.nodes[n];
+        highlights.prepend({ node.bodyBegin, node.bodyEnd, QColor(190, 220, 255) });
+    }
+    highlights.append({ e.module->bodyBegin, e.module->bodyEnd, QColor(255, 230, 150) });
+    m_hexView->setHighlights(highlights);
+    m_hexView->scrollToOffset(e.module->bodyBegin);
+}
+
+void MainWindow::onGotoRequested()
+{
+    if (!m_result.success) return;
+    ensureFunctionIndex();
+    m_gotoDialog->open();
+}
+
+void MainWindow::selectFunctionRow(int sourceRow)
+{
+    QModelIndex proxyIndex = m_functionsProxy->mapFromSource(m_functionsModel->index(sourceRow, 0));
+    if (!proxyIndex.isValid() && !m_searchEdit->text().isEmpty()) {
+        // Filtered out by the search box
+        m_searchEdit->clear();
+        proxyIndex = m_functionsProxy->mapFromSource(m_functionsModel->index(sourceRow, 0));
+    }
+    if (!proxyIndex.isValid()) return;
+    m_functionsTable->setCurrentIndex(proxyIndex);
+    m_functionsTable->scrollTo(proxyIndex, QAbstractItemView::PositionAtCenter);
+}
+
+void MainWindow::onExportVisibleRows()
+{
+    if (!m_result.success || m_exportWatcher.isRunning()) return;
+    QString filter;
+    const QString path = QFileDialog::getSaveFileName(this, tr("Export visible rows"), QString(),
+        tr("CSV (*.csv);;TSV (*.tsv);;NDJSON (*.ndjson)"), &filter);
+    if (path.isEmpty()) return;
+    SigParser::ExportFormat format = SigParser::exportFormatForPath(path);
+    if (filter.startsWith("TSV")) format = SigParser::ExportFormat::Tsv;
+    else if (filter.startsWith("NDJSON")) format = SigParser::ExportFormat::Ndjson;
+
+    // Rows in view order: filtered and sorted by the proxy
+    QVector<int> rows;
+    rows.reserve(m_functionsProxy->rowCount());
+    for (int r = 0; r < m_functionsProxy->rowCount(); ++r)
+        rows.append(m_functionsProxy->mapToSource(m_functionsProxy->index(r, 0)).row());
+    startExport(rows, format, path);
+}
+
+void MainWindow::onCopySelection()
+{
+    if (!m_result.success || m_exportWatcher.isRunning()) return;
+    QModelIndexList selected = m_functionsTable->selectionModel()->selectedRows();
+    std::sort(selected.begin(), selected.end(), [](const QModelIndex &a, const QModelIndex &b) { return a.row() < b.row(); });
+    QVector<int> rows;
+    rows.reserve(selected.size());
+    for (const QModelIndex &idx : selected)
+        rows.append(m_functionsProxy->mapToSource(idx).row());
+    if (!rows.isEmpty())
+        startExport(rows, SigParser::ExportFormat::Tsv, QString());
+}
+
+void MainWindow::startExport(const QVector<int> &sourceRows, SigParser::ExportFormat format, const QString &path)
+{
+    m_exportPath = path;
+    m_exportProgress->setRange(0, sourceRows.size());
+    m_exportProgress->setValue(0);
+    m_exportProgress->show();
+    m_exportCancel->show();
+    statusBar()->showMessage(path.isEmpty() ? tr("Copying %1 rows...").arg(sourceRows.size())
+                                            : tr("Exporting %1 rows...").arg(sourceRows.size()));
+    m_exportWatcher.setFuture(QtConcurrent::run([result = m_result, sourceRows, format, path](QPromise<QString> &promise) {
+        promise.setProgressRange(0, sourceRows.size());
+        auto progress = [&promise](int done) {
+            promise.setProgressValue(done);
+            return !promise.isCanceled();
+        };
+        if (path.isEmpty()) {
+            // Clipboard text, decoded chunk by chunk on this thread
+            QString text;
+            Utf8DecodingDevice device(&text);
+            device.open(QIODevice::WriteOnly);
+            if (SigParser::exportFunctions(result, sourceRows, format, &device, progress))
+                promise.addResult(text);
+            return;
+        }
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) return;
+        if (SigParser::exportFunctions(result, sourceRows, format, &file, progress) && file.commit())
+            promise.addResult(QString());
+        else
+            file.cancelWriting();
+    }));
+}
+
+void MainWindow::onExportFinished()
+{
+    m_exportProgress->hide();
+    m_exportCancel->hide();
+    if (m_exportWatcher.isCanceled() || m_exportWatcher.future().resultCount() == 0) {
+        statusBar()->showMessage(m_exportWatcher.isCanceled() ? tr("Export canceled")
+                                                              : tr("Export failed: ") + m_exportPath, 5000);
+        return;
+    }
+    if (m_exportPath.isEmpty()) {
+        QGuiApplication::clipboard()->setText(m_exportWatcher.result());
+        statusBar()->showMessage(tr("Copied to clipboard"), 3000);
+    } else {
+        statusBar()->showMessage(tr("Exported: ") + m_exportPath, 3000);
+    }
+}
+
+void MainWindow::onScanCorpus()
+{
+    if (m_exportWatcher.isRunning() || m_corpusWatcher.isRunning()) return;
+    const QVector<SigParser::CorpusSignature> signatures = m_identifyWidget->compiledSignatures();
+    if (signatures.isEmpty()) {
+        QMessageBox::information(this, tr("Scan corpus"),
+                                 tr("Open a signature or add signatures in the Identify panel first."));
+        return;
+    }
+    const QString dir = QFileDialog::getExistingDirectory(this, tr("Folder of binaries"));
+    if (dir.isEmpty()) return;
+    const QString path = QFileDialog::getSaveFileName(this, tr("Scan results"), QString(), tr("NDJSON (*.ndjson)"));
+    if (path.isEmpty()) return;
+
+    m_corpusOutput = path;
+    m_exportProgress->setRange(0, 0);
+    m_exportProgress->show();
+    m_exportCancel->show();
+    statusBar()->showMessage(tr("Listing %1...").arg(dir));
+    const double minConfidence = m_identifyWidget->minConfidence();
+    m_corpusStop = std::make_shared<std::atomic<bool>>(false);
+    const std::shared_ptr<std::atomic<bool>> stop = m_corpusStop;
+    m_corpusWatcher.setFuture(QtConcurrent::run([signatures, dir, path, minConfidence, stop](QPromise<SigParser::CorpusStats> &promise) {
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) return;
+        const QVector<SigParser::CorpusFile> files = SigParser::listCorpus(dir);
+        promise.setProgressRange(0, files.size());
+        int done = 0;
+        bool writeOk = true;
+        // Shared with other SigViewer windows and the CLI through the cache's lock file
+        SigParser::MatchCache cache(SigParser::MatchCache::defaultDirectory());
+        SigParser::CorpusScanOptions options;
+        options.minConfidence = minConfidence;
+        options.cache = &cache;
+        const SigParser::CorpusStats stats = SigParser::scanCorpus(files, signatures, options, [&](const SigParser::CorpusFileResult &r) {
+            const QByteArray line = r.toNdjson(signatures);
+            writeOk = file.write(line) == line.size();
+            ++done;
+            promise.setProgressValueAndText(done, tr("Scanned %1 of %2: %3").arg(done).arg(files.size()).arg(r.path));
+            return writeOk && !*stop;
+        });
+        file.write(stats.toNdjson());
+        // A canceled scan still keeps the files finished so far
+        if (writeOk && file.commit())
+            promise.addResult(stats);
+        else
+            file.cancelWriting();
+    }));
+}
+
+void MainWindow::onCorpusScanFinished()
+{
+    m_exportProgress->hide();
+    m_exportCancel->hide();
+    if (m_corpusWatcher.future().resultCount() == 0) {
+        statusBar()->showMessage(tr("Corpus scan failed: ") + m_corpusOutput, 5000);
+        return;
+    }
+    const SigParser::CorpusStats stats = m_corpusWatcher.result();
+    const double seconds = stats.wallNs / 1e9;
+    statusBar()->showMessage(tr("%1%2 files (%3 cached), %4 matches in %5 s (%6 MiB/s) written to %7")
+                                 .arg(stats.canceled ? tr("Canceled after ") : QString())
+                                 .arg(stats.files).arg(stats.cacheHits).arg(stats.matches).arg(seconds, 0, 'f', 1)
+                                 .arg(seconds > 0 ? stats.bytes / (1024.0 * 1024.0) / seconds : 0.0, 0, 'f', 1)
+                                 .arg(m_corpusOutput));
+}
+
 void MainWindow::onFunctionSelectionChanged()
 {
     refreshRulesForSelection();
+    refreshHexSelection();
 }
 
 void MainWindow::dragEnterEvent(QDragEnterEvent *event)
@@ -237,36 +705,52 @@ void MainWindow::dropEvent(QDropEvent *event)
     QString path = urls.first().toLocalFile();
     if (path.endsWith(".sig", Qt::CaseInsensitive) || path.endsWith(".sig.gz", Qt::CaseInsensitive)) {
         event->acceptProposedAction();
-        if (loadSigFile(path))
-            statusBar()->showMessage("Loaded: " + path, 3000);
-        else
-            statusBar()->showMessage("Failed to load: " + path, 5000);
+        loadSigFile(path);
     }
 }
 
-bool MainWindow::loadSigFile(const QString &path)
+void MainWindow::loadSigFile(const QString &path)
 {
-    QFile f(path);
-    if (!f.open(QIODevice::ReadOnly)) {
-        QMessageBox::warning(this, "SigViewer", "Cannot open file: " + path);
-        return false;
+    // An older parse stops at its next batch; batches it already queued are dropped by generation
+    const quint64 generation = ++m_loadGeneration;
+    m_supersededLoads.removeIf([](const QFuture<SigParser::FlirtResult> &load) { return load.isFinished(); });
+    if (!m_loadWatcher.isFinished()) {
+        m_loadWatcher.cancel();
+        m_supersededLoads.append(m_loadWatcher.future());
     }
-    QByteArray data = f.readAll();
-    f.close();
-    if (path.endsWith(".sig.gz", Qt::CaseInsensitive)) {
-        data = SigParser::FlirtParser::decompressGzip(data);
-        if (data.isEmpty()) {
-            QMessageBox::warning(this, "SigViewer", "Failed to decompress .sig.gz file.");
-            return false;
-        }
-    }
-    SigParser::FlirtParser parser;
-    SigParser::FlirtResult result = parser.parse(data);
+    m_loadWatcher.setFuture(QFuture<SigParser::FlirtResult>());
+    clearSig();
+    m_loadingPath = path;
+    m_functionsTable->setSortingEnabled(false);
+    m_functionsModel->beginLoading();
+    statusBar()->showMessage("Loading: " + path);
+
+    const QPointer<MainWindow> self(this);
+    m_loadWatcher.setFuture(QtConcurrent::run([self, path, generation](QPromise<SigParser::FlirtResult> &promise) {
+        SigParser::FlirtParser parser;
+        parser.setModuleBatchCallback([&promise, self, generation](const QVector<SigParser::FlirtModule> &batch) {
+            if (promise.isCanceled()) return false;
+            QMetaObject::invokeMethod(self, [self, generation, batch]() {
+                if (self && generation == self->m_loadGeneration)
+                    self->m_functionsModel->appendModules(batch);
+            }, Qt::QueuedConnection);
+            return true;
+        });
+        promise.addResult(parser.parseFile(path));
+    }));
+}
+
+void MainWindow::onLoadFinished()
+{
+    if (m_loadWatcher.isCanceled()) return;
+    const SigParser::FlirtResult result = m_loadWatcher.result();
+    m_functionsTable->setSortingEnabled(true);
     if (!result.success) {
-        QMessageBox::warning(this, "SigViewer", "Parse error: " + result.errorMessage);
         clearSig();
-        return false;
+        statusBar()->showMessage("Failed to load: " + m_loadingPath, 5000);
+        QMessageBox::warning(this, "SigViewer", result.errorMessage);
+        return;
     }
     setSigResult(result);
-    return true;
+    statusBar()->showMessage("Loaded: " + m_loadingPath, 3000);
 }
@@ -1,13 +1,32 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include <QFutureWatcher>
 #include <QMainWindow>
+#include <atomic>
+#include <memory>
+#include "sigparser/corpusscan.h"
 #include "sigparser/flirtparser.h"
+#include "sigparser/flirtheatmap.h"
+#include "sigparser/flirtstats.h"
+#include "sigparser/functionexport.h"
+#include "sigparser/functionindex.h"
+#include "sigparser/trieprofile.h"
 #include "DockManager.h"
 
+class QComboBox;
 class QLineEdit;
 class QPlainTextEdit;
-class QTableWidget;
+class QProgressBar;
+class QToolButton;
+class QTableView;
+class FunctionsFilterModel;
+class FunctionsModel;
+class GotoDialog;
+class HeatMapWidget;
+class HexViewWidget;
+class IdentifyWidget;
+class StatisticsWidget;
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -29,25 +48,76 @@ public:
 private slots:
     void onFunctionSelectionChanged();
     void onSearchTextChanged(const QString &text);
+    void onStatisticsFinished();
+    void onHeatMapFinished();
+    void onTrieProfileFinished();
+    void onLoadFinished();
+    void onGotoRequested();
+    void selectFunctionRow(int sourceRow);
+    void onExportVisibleRows();
+    void onCopySelection();
+    void onExportFinished();
+    void onScanCorpus();
+    void onCorpusScanFinished();
 
 protected:
     void dragEnterEvent(QDragEnterEvent *event) override;
     void dropEvent(QDropEvent *event) override;
 
 private:
-    bool loadSigFile(const QString &path);
+    void loadSigFile(const QString &path);
     void refreshLibraryInfo();
     void refreshFunctionsTable();
     void refreshRulesForSelection();
     void applyTableFilter();
+    SigParser::FlirtResult::FunctionEntry currentFunctionEntry() const;
+    const SigParser::FunctionIndex &ensureFunctionIndex();
+    void refreshStatistics();
+    void refreshHeatMap();
+    void refreshTrieProfile();
+    void refreshHexSelection();
+    void startExport(const QVector<int> &sourceRows, SigParser::ExportFormat format, const QString &path);
 
     Ui::MainWindow *ui;
     SigParser::FlirtResult m_result;
     ads::CDockManager *m_dockManager;
     QPlainTextEdit *m_libraryInfoText;
+    enum SearchMode { SearchContains, SearchFuzzy, SearchBytes };
     QLineEdit *m_searchEdit;
-    QTableWidget *m_functionsTable;
+    QComboBox *m_searchModeCombo;
+    QTableView *m_functionsTable;
+    FunctionsModel *m_functionsModel;
+    FunctionsFilterModel *m_functionsProxy;
+    GotoDialog *m_gotoDialog;
+    std::shared_ptr<const SigParser::FunctionIndex> m_functionIndex;  // built on first Go-to for m_result
+    // Export / copy running on the thread pool; an empty m_exportPath means clipboard
+    QFutureWatcher<QString> m_exportWatcher;
+    QString m_exportPath;
+    QProgressBar *m_exportProgress;
+    QToolButton *m_exportCancel;
+    // Corpus scan with the Identify signatures, streaming NDJSON to m_corpusOutput
+    QFutureWatcher<SigParser::CorpusStats> m_corpusWatcher;
+    // Cancel asks the scan to stop instead of canceling the future, so its stats still arrive
+    std::shared_ptr<std::atomic<bool>> m_corpusStop;
+    QString m_corpusOutput;
     QPlainTextEdit *m_rulesText;
+    // Background loading; rows stream into m_functionsModel before m_result is set
+    QFutureWatcher<SigParser::FlirtResult> m_loadWatcher;
+    QList<QFuture<SigParser::FlirtResult>> m_supersededLoads;  // canceled, possibly still running
+    quint64 m_loadGeneration = 0;
+    QString m_loadingPath;
+    ads::CDockWidget *m_statisticsDock;
+    StatisticsWidget *m_statisticsWidget;
+    QFutureWatcher<SigParser::FlirtStatistics> m_statisticsWatcher;
+    bool m_statisticsValid = false;  // m_statisticsWidget shows stats for m_result
+    HeatMapWidget *m_heatMapWidget;
+    QFutureWatcher<SigParser::BytePositionHistogram> m_heatMapWatcher;
+    bool m_heatMapValid = false;
+    HexViewWidget *m_hexView;
+    IdentifyWidget *m_identifyWidget;
+    QPlainTextEdit *m_trieProfileText;
+    QFutureWatcher<SigParser::TrieProfile> m_trieProfileWatcher;
+    bool m_trieProfileValid = false;
 };
 
 #endif // MAINWINDOW_H
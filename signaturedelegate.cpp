@@ -0,0 +1,146 @@
+#include "signaturedelegate.h"
+#include "functionsmodel.h"
+#include <QApplication>
+#include <QFontDatabase>
+#include <QPainter>
+#include <QTextLayout>
+#include <QtMath>
+
+static constexpr int TEXT_MARGIN = 3;
+
+static QGlyphRun shapeRun(const QString &text, const QFont &font)
+{
+    QTextLayout layout(text, font);
+    layout.beginLayout();
+    layout.createLine();
+    layout.endLayout();
+    const QList<QGlyphRun> runs = layout.glyphRuns();
+    return runs.isEmpty() ? QGlyphRun() : runs.first();
+}
+
+// Fixed-pitch font matching the view font's size, so every hex pair has the same advance
+static QFont patternFont(const QFont &viewFont)
+{
+    QFont font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    if (viewFont.pointSizeF() > 0)
+        font.setPointSizeF(viewFont.pointSizeF());
+    else
+        font.setPixelSize(viewFont.pixelSize());
+    return font;
+}
+
+// Width of the whole pattern path without building its string
+static qreal patternWidth(const SigParser::FlirtModule &mod, qreal pairWidth, qreal gapWidth)
+{
+    qsizetype bytes = 0;
+    for (const auto &n : mod.patternPath)
+        bytes += n.patternBytes.size();
+    return bytes * pairWidth + qMax<qsizetype>(0, mod.patternPath.size() - 1) * gapWidth;
+}
+
+SignatureDelegate::SignatureDelegate(const FunctionsModel *model, QObject *parent)
+    : QStyledItemDelegate(parent)
+    , m_model(model)
+{
+}
+
+void SignatureDelegate::ensureGlyphs(const QFont &viewFont) const
+{
+    if (m_glyphsValid && viewFont == m_font) return;
+    m_font = viewFont;
+    const QFont font = patternFont(viewFont);
+    for (int b = 0; b < 256; ++b)
+        m_pairs[b] = shapeRun(QString("%1").arg(b, 2, 16, QChar('0')).toUpper(), font);
+    m_variant = shapeRun("..", font);
+    m_ellipsis = shapeRun(QString(QChar(0x2026)), font);
+    const QFontMetricsF fm(font);
+    m_pairWidth = fm.horizontalAdvance("00");
+    m_gapWidth = fm.horizontalAdvance(' ');
+    m_ellipsisWidth = fm.horizontalAdvance(QChar(0x2026));
+    m_lineHeight = fm.height();
+    m_glyphsValid = true;
+}
+
+void SignatureDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    const SigParser::FlirtResult::FunctionEntry e = m_model->entry(index.data(FunctionsModel::EntryIndexRole).toInt());
+    if (!e.module) {
+        QStyledItemDelegate::paint(painter, option, index);
+        return;
+    }
+
+    // Background, selection and focus only; initStyleOption() would fetch the display string
+    QStyleOptionViewItem opt = option;
+    opt.text.clear();
+    opt.features &= ~QStyleOptionViewItem::HasDisplay;
+    const QWidget *widget = opt.widget;
+    QStyle *style = widget ? widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, widget);
+
+    ensureGlyphs(opt.font);
+    const bool selected = opt.state & QStyle::State_Selected;
+    const QPalette::ColorGroup group = (opt.state & QStyle::State_Enabled) ? QPalette::Normal : QPalette::Disabled;
+    const QColor textColor = opt.palette.color(group, selected ? QPalette::HighlightedText : QPalette::Text);
+    QColor variantColor = textColor;
+    variantColor.setAlphaF(0.4f);
+    QColor markColor = textColor;
+    markColor.setAlphaF(0.25f);
+
+    const QRectF r = QRectF(opt.rect).adjusted(TEXT_MARGIN, 0, -TEXT_MARGIN, 0);
+    const qreal top = r.top() + (r.height() - m_lineHeight) / 2;
+    const bool fits = patternWidth(*e.module, m_pairWidth, m_gapWidth) <= r.width();
+    const qreal limit = fits ? r.right() : r.right() - m_ellipsisWidth;
+
+    painter->save();
+    painter->setClipRect(opt.rect);
+    enum { NoPen, TextPen, VariantPen } pen = NoPen;
+    qreal x = r.left();
+    bool elided = false;
+    const auto &path = e.module->patternPath;
+    for (int ni = 0; ni < path.size() && !elided; ++ni) {
+        if (ni > 0) {
+            if (x + m_gapWidth > limit) {
+                elided = true;
+                break;
+            }
+            // Node boundary marker in the middle of the gap
+            painter->setPen(markColor);
+            pen = NoPen;
+            const qreal mx = x + m_gapWidth / 2;
+            painter->drawLine(QPointF(mx, r.top() + 3), QPointF(mx, r.bottom() - 3));
+            x += m_gapWidth;
+        }
+        const QByteArray &bytes = path[ni].patternBytes;
+        const QByteArray &mask = path[ni].variantMask;
+        for (qsizetype i = 0; i < bytes.size(); ++i) {
+            if (x + m_pairWidth > limit) {
+                elided = true;
+                break;
+            }
+            const bool variant = i < mask.size() && mask[i];
+            if (variant && pen != VariantPen) {
+                painter->setPen(variantColor);
+                pen = VariantPen;
+            } else if (!variant && pen != TextPen) {
+                painter->setPen(textColor);
+                pen = TextPen;
+            }
+            painter->drawGlyphRun(QPointF(x, top), variant ? m_variant : m_pairs[static_cast<quint8>(bytes[i])]);
+            x += m_pairWidth;
+        }
+    }
+    if (elided) {
+        painter->setPen(textColor);
+        painter->drawGlyphRun(QPointF(x, top), m_ellipsis);
+    }
+    painter->restore();
+}
+
+QSize SignatureDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    const SigParser::FlirtResult::FunctionEntry e = m_model->entry(index.data(FunctionsModel::EntryIndexRole).toInt());
+    if (!e.module) return QStyledItemDelegate::sizeHint(option, index);
+    ensureGlyphs(option.font);
+    const qreal w = patternWidth(*e.module, m_pairWidth, m_gapWidth) + 2 * TEXT_MARGIN;
+    return QSize(qCeil(w), qCeil(m_lineHeight) + 2 * TEXT_MARGIN);
+}
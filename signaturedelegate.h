@@ -0,0 +1,38 @@
+#ifndef SIGNATUREDELEGATE_H
+#define SIGNATUREDELEGATE_H
+
+#include <QFont>
+#include <QGlyphRun>
+#include <QStyledItemDelegate>
+
+class FunctionsModel;
+
+// Paints a module's pattern path straight from node bytes and variant masks using
+// pre-shaped glyph runs for the 256 hex pairs and "..", so no per-row strings are built.
+class SignatureDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    SignatureDelegate(const FunctionsModel *model, QObject *parent = nullptr);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+private:
+    void ensureGlyphs(const QFont &viewFont) const;
+
+    const FunctionsModel *m_model;
+    // Glyph cache, rebuilt when the view font changes
+    mutable QFont m_font;  // view font the cache was built for
+    mutable bool m_glyphsValid = false;
+    mutable QGlyphRun m_pairs[256];
+    mutable QGlyphRun m_variant;
+    mutable QGlyphRun m_ellipsis;
+    mutable qreal m_pairWidth = 0;
+    mutable qreal m_gapWidth = 0;
+    mutable qreal m_ellipsisWidth = 0;
+    mutable qreal m_lineHeight = 0;
+};
+
+#endif // SIGNATUREDELEGATE_H
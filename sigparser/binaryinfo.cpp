@@ -0,0 +1,201 @@
+#include "binaryinfo.h"
+#include "dexfile.h"
+#include <QFile>
+#include <algorithm>
+
+namespace SigParser {
+
+static constexpr qsizetype BINARY_PROBE_BYTES = 4096;
+
+static quint16 le16(const QByteArray &d, qsizetype at) {
+    return static_cast<quint16>(static_cast<quint8>(d[at]) | (static_cast<quint8>(d[at + 1]) << 8));
+}
+
+static quint32 le32(const QByteArray &d, qsizetype at) {
+    return le16(d, at) | (static_cast<quint32>(le16(d, at + 2)) << 16);
+}
+
+static quint16 be16(const QByteArray &d, qsizetype at) {
+    return static_cast<quint16>((static_cast<quint8>(d[at]) << 8) | static_cast<quint8>(d[at + 1]));
+}
+
+static quint32 be32(const QByteArray &d, qsizetype at) {
+    return (static_cast<quint32>(be16(d, at)) << 16) | be16(d, at + 2);
+}
+
+static quint64 le64(const QByteArray &d, qsizetype at) {
+    return le32(d, at) | (static_cast<quint64>(le32(d, at + 4)) << 32);
+}
+
+static quint64 be64(const QByteArray &d, qsizetype at) {
+    return (static_cast<quint64>(be32(d, at)) << 32) | be32(d, at + 4);
+}
+
+static void addCodeRange(BinaryInfo &info, quint64 begin, quint64 size, qsizetype fileSize) {
+    // begin and size come from the file; compare against what is left so nothing wraps
+    const quint64 total = static_cast<quint64>(fileSize);
+    if (begin >= total || size == 0) return;
+    const quint64 end = begin + std::min(size, total - begin);
+    info.codeRanges.append({ static_cast<qint64>(begin), static_cast<qint64>(end) });
+}
+
+static void setBits(BinaryInfo &info, int bits) {
+    info.bits = bits;
+    info.appType |= bits == 64 ? IDASIG_APP_64_BIT : (bits == 32 ? IDASIG_APP_32_BIT : IDASIG_APP_16_BIT);
+}
+
+static bool probePe(const QByteArray &d, quint32 peOffset, BinaryInfo &info) {
+    // COFF file header (20 bytes) followed by the optional header
+    if (d.size() < 24 + 70 || peOffset > static_cast<quint64>(d.size() - 24 - 70)) return false;
+    const quint16 machine = le16(d, peOffset + 4);
+    const quint16 characteristics = le16(d, peOffset + 22);
+    const qsizetype opt = peOffset + 24;
+    const quint16 magic = le16(d, opt);
+    const quint16 subsystem = le16(d, opt + 68);
+    QString machineName;
+    switch (machine) {
+    case 0x014c: info.arch = IDASIG_ARCH_386; machineName = "x86"; break;
+    case 0x8664: info.arch = IDASIG_ARCH_386; machineName = "x86-64"; break;
+    case 0x01c0:
+    case 0x01c2:
+    case 0x01c4: info.arch = IDASIG_ARCH_ARM; machineName = "ARM"; break;
+    case 0xaa64: info.arch = IDASIG_ARCH_ARM; machineName = "ARM64"; break;
+    case 0x0200: info.arch = IDASIG_ARCH_IA64; machineName = "IA-64"; break;
+    case 0x0166: info.arch = IDASIG_ARCH_MIPS; machineName = "MIPS"; break;
+    case 0x01f0: info.arch = IDASIG_ARCH_PPC; machineName = "PowerPC"; break;
+    default: return false;
+    }
+    info.format = BinaryInfo::Format::Pe;
+    info.fileType = IDASIG_FILE_PE;
+    info.osType = IDASIG_OS_WIN;
+    setBits(info, magic == 0x20b ? 64 : 32);
+    const bool dll = characteristics & 0x2000;
+    if (subsystem == 1) info.appType |= IDASIG_APP_DRV;  // native
+    else if (dll) info.appType |= IDASIG_APP_DLL;
+    else info.appType |= IDASIG_APP_EXE;
+    if (subsystem == 2) info.appType |= IDASIG_APP_GRAPHICS;
+    if (subsystem == 3) info.appType |= IDASIG_APP_CONSOLE;
+    // Section table after the optional header: 40-byte entries
+    const quint16 sections = le16(d, peOffset + 6);
+    const qsizetype table = opt + le16(d, peOffset + 20);
+    for (int i = 0; i < sections && table + (i + 1) * 40 <= d.size(); ++i) {
+        const qsizetype sec = table + i * 40;
+        if (le32(d, sec + 36) & (0x20 | 0x20000000))  // contains code / executable
+            addCodeRange(info, le32(d, sec + 20), le32(d, sec + 16), d.size());
+    }
+    const QString kind = subsystem == 1 ? "driver" : (dll ? "DLL" : "EXE");
+    info.description = QString("%1 %2 %3").arg(magic == 0x20b ? QString("PE32+") : QString("PE32"), machineName, kind);
+    return true;
+}
+
+static bool probeElf(const QByteArray &d, BinaryInfo &info) {
+    if (d.size() < 20) return false;
+    const int elfClass = static_cast<quint8>(d[4]);
+    const bool bigEndian = static_cast<quint8>(d[5]) == 2;
+    if (elfClass != 1 && elfClass != 2) return false;
+    const quint16 type = bigEndian ? be16(d, 16) : le16(d, 16);
+    const quint16 machine = bigEndian ? be16(d, 18) : le16(d, 18);
+    QString machineName;
+    switch (machine) {
+    case 3: info.arch = IDASIG_ARCH_386; machineName = "x86"; break;
+    case 62: info.arch = IDASIG_ARCH_386; machineName = "x86-64"; break;
+    case 40: info.arch = IDASIG_ARCH_ARM; machineName = "ARM"; break;
+    case 183: info.arch = IDASIG_ARCH_ARM; machineName = "AArch64"; break;
+    case 8: info.arch = IDASIG_ARCH_MIPS; machineName = "MIPS"; break;
+    case 20:
+    case 21: info.arch = IDASIG_ARCH_PPC; machineName = "PowerPC"; break;
+    case 2:
+    case 18:
+    case 43: info.arch = IDASIG_ARCH_SPARC; machineName = "SPARC"; break;
+    case 42: info.arch = IDASIG_ARCH_SH; machineName = "SuperH"; break;
+    case 50: info.arch = IDASIG_ARCH_IA64; machineName = "IA-64"; break;
+    case 4: info.arch = IDASIG_ARCH_68K; machineName = "68K"; break;
+    default: return false;
+    }
+    info.format = BinaryInfo::Format::Elf;
+    info.fileType = IDASIG_FILE_ELF;
+    info.osType = IDASIG_OS_UNIX;
+    setBits(info, elfClass == 2 ? 64 : 32);
+    // ET_DYN covers both shared objects and position-independent executables
+    if (type == 2) info.appType |= IDASIG_APP_EXE;
+    else if (type == 3) info.appType |= IDASIG_APP_EXE | IDASIG_APP_DLL;
+    // Executable PT_LOAD segments from the program header table
+    auto u16 = [&](qsizetype at) { return bigEndian ? be16(d, at) : le16(d, at); };
+    auto u32 = [&](qsizetype at) { return bigEndian ? be32(d, at) : le32(d, at); };
+    auto u64 = [&](qsizetype at) { return bigEndian ? be64(d, at) : le64(d, at); };
+    const bool is64 = elfClass == 2;
+    if (d.size() >= (is64 ? 64 : 52)) {
+        const quint64 size = static_cast<quint64>(d.size());
+        const quint64 phoff = is64 ? u64(32) : u32(28);
+        const quint16 phentsize = u16(is64 ? 54 : 42);
+        const quint16 phnum = u16(is64 ? 56 : 44);
+        // phoff is arbitrary file data: bound it before any arithmetic that could wrap
+        const bool tableFits = phoff <= size && phentsize >= (is64 ? 56 : 32) && phentsize <= size - phoff;
+        const quint64 entries = tableFits ? std::min<quint64>(phnum, (size - phoff) / phentsize) : 0;
+        for (quint64 i = 0; i < entries; ++i) {
+            const qsizetype ph = static_cast<qsizetype>(phoff + i * phentsize);
+            const quint32 flags = u32(ph + (is64 ? 4 : 24));
+            if (u32(ph) != 1 || !(flags & 1)) continue;  // PT_LOAD with PF_X
+            if (is64) addCodeRange(info, u64(ph + 8), u64(ph + 32), d.size());
+            else addCodeRange(info, u32(ph + 4), u32(ph + 16), d.size());
+        }
+    }
+    const QString kind = type == 3 ? "shared object" : (type == 2 ? "executable" : "object");
+    info.description = QString("ELF%1 %2 %3").arg(elfClass == 2 ? 64 : 32).arg(machineName, kind);
+    return true;
+}
+
+BinaryInfo probeBinary(const QByteArray &head) {
+    BinaryInfo info;
+    if (head.size() >= 4 && head.startsWith("\x7f" "ELF")) {
+        if (!probeElf(head, info)) info = BinaryInfo();
+        return info;
+    }
+    if (isDex(head)) {
+        info.format = BinaryInfo::Format::Dex;
+        info.arch = IDASIG_ARCH_DALVIK;
+        setBits(info, 32);
+        info.description = "DEX " + QString::fromLatin1(head.mid(4, 3));
+        return info;
+    }
+    if (head.size() < 64 || !head.startsWith("MZ")) return info;
+    const quint32 newHeader = le32(head, 0x3c);
+    if (newHeader <= static_cast<quint64>(head.size() - 4)) {
+        const QByteArray sig = head.mid(newHeader, 4);
+        if (sig == QByteArray("PE\0\0", 4)) {
+            if (!probePe(head, newHeader, info)) info = BinaryInfo();
+            return info;
+        }
+        if (sig.startsWith("NE")) {
+            info.format = BinaryInfo::Format::Ne;
+            info.arch = IDASIG_ARCH_386;
+            info.fileType = IDASIG_FILE_NE;
+            info.osType = IDASIG_OS_WIN;
+            info.appType = IDASIG_APP_EXE;
+            setBits(info, 16);
+            info.description = "NE 16-bit Windows";
+            return info;
+        }
+    }
+    info.format = BinaryInfo::Format::DosMz;
+    info.arch = IDASIG_ARCH_386;
+    info.fileType = IDASIG_FILE_DOS_EXE | IDASIG_FILE_DOS_EXE_OLD;
+    info.osType = IDASIG_OS_MSDOS;
+    info.appType = IDASIG_APP_EXE;
+    setBits(info, 16);
+    info.description = "DOS MZ executable";
+    return info;
+}
+
+BinaryInfo probeBinaryFile(const QString &path, QString *error) {
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        if (error) *error = "Cannot open file: " + path;
+        return BinaryInfo();
+    }
+    const BinaryInfo info = probeBinary(f.read(BINARY_PROBE_BYTES));
+    if (!info.isValid() && error) *error = "Unrecognised executable format: " + path;
+    return info;
+}
+
+} // namespace SigParser
@@ -0,0 +1,36 @@
+#ifndef BINARYINFO_H
+#define BINARYINFO_H
+
+#include "flirtparser.h"
+#include <QPair>
+
+namespace SigParser {
+
+// What a signature needs to know about a target binary, in FLIRT header terms
+struct BinaryInfo {
+    enum class Format { Unknown, DosMz, Ne, Pe, Elf, Dex };
+    Format format = Format::Unknown;
+    quint8 arch = 0;        // IDASIG_ARCH_*
+    int bits = 0;           // 16, 32 or 64
+    quint32 fileType = 0;   // IDASIG_FILE_* bit of the format
+    quint16 osType = 0;     // IDASIG_OS_*
+    quint16 appType = 0;    // IDASIG_APP_*: program kind, subsystem and bitness
+    QString description;    // e.g. "PE32+ x86-64 DLL"
+    // File offset ranges [first, second) of executable sections (PE) or segments (ELF); empty
+    // for DEX, whose function starts are the methods listed by parseDexMethods()
+    QVector<QPair<qint64, qint64>> codeRanges;
+
+    bool isValid() const { return format != Format::Unknown; }
+};
+
+/**
+ * Identify a DOS MZ, NE, PE, ELF or DEX image from its first bytes (the first 4 KiB are enough).
+ * codeRanges is only filled from section or program headers that lie within data.
+ */
+BinaryInfo probeBinary(const QByteArray &head);
+/** probeBinary() on the start of a file; errors leave the result invalid and set error. */
+BinaryInfo probeBinaryFile(const QString &path, QString *error = nullptr);
+
+} // namespace SigParser
+
+#endif // BINARYINFO_H
@@ -0,0 +1,229 @@
+#include "compacttrie.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace SigParser {
+
+static constexpr int RANK_BLOCK_WORDS = 8;
+
+static inline int popcount64(quint64 x) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return static_cast<int>(__popcnt64(x));
+#else
+    return __builtin_popcountll(x);
+#endif
+}
+
+// Position of the k-th (0-based) set bit of x
+static inline int selectInWord(quint64 x, int k) {
+    for (int i = 0; i < k; ++i)
+        x &= x - 1;
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+void RankSelectBits::append(bool bit) {
+    if ((m_size & 63) == 0) m_words.append(0);
+    if (bit) {
+        m_words.last() |= quint64(1) << (m_size & 63);
+        ++m_ones;
+    }
+    ++m_size;
+}
+
+void RankSelectBits::finish() {
+    m_blockRank.clear();
+    m_blockRank.reserve(m_words.size() / RANK_BLOCK_WORDS + 2);
+    quint32 ones = 0;
+    for (int w = 0; w < m_words.size(); ++w) {
+        if (w % RANK_BLOCK_WORDS == 0) m_blockRank.append(ones);
+        ones += popcount64(m_words[w]);
+    }
+    m_blockRank.append(ones);
+    m_words.squeeze();
+}
+
+qsizetype RankSelectBits::rank1(qsizetype pos) const {
+    if (pos <= 0) return 0;
+    if (pos >= m_size) return m_ones;
+    const qsizetype word = pos >> 6;
+    qsizetype r = m_blockRank[word / RANK_BLOCK_WORDS];
+    for (qsizetype w = word - word % RANK_BLOCK_WORDS; w < word; ++w)
+        r += popcount64(m_words[w]);
+    const int bits = pos & 63;
+    if (bits) r += popcount64(m_words[word] & ((quint64(1) << bits) - 1));
+    return r;
+}
+
+template <bool One>
+qsizetype RankSelectBits::select(qsizetype k) const {
+    const qsizetype total = One ? m_ones : m_size - m_ones;
+    if (k < 0 || k >= total) return -1;
+    auto countBefore = [this](qsizetype block) -> qsizetype {
+        const qsizetype ones = m_blockRank[block];
+        return One ? ones : block * RANK_BLOCK_WORDS * 64 - ones;
+    };
+    // Last block whose count before it is <= k
+    qsizetype lo = 0;
+    qsizetype hi = m_blockRank.size() - 2;
+    while (lo < hi) {
+        const qsizetype mid = (lo + hi + 1) / 2;
+        if (countBefore(mid) <= k) lo = mid;
+        else hi = mid - 1;
+    }
+    qsizetype remaining = k - countBefore(lo);
+    for (qsizetype w = lo * RANK_BLOCK_WORDS; w < m_words.size(); ++w) {
+        const quint64 bits = One ? m_words[w] : ~m_words[w];
+        const int n = popcount64(bits);
+        if (remaining < n) return w * 64 + selectInWord(bits, static_cast<int>(remaining));
+        remaining -= n;
+    }
+    return -1;
+}
+
+qsizetype RankSelectBits::select1(qsizetype k) const {
+    return select<true>(k);
+}
+
+qsizetype RankSelectBits::select0(qsizetype k) const {
+    return select<false>(k);
+}
+
+qsizetype RankSelectBits::memoryBytes() const {
+    return m_words.size() * qsizetype(sizeof(quint64)) + m_blockRank.size() * qsizetype(sizeof(quint32));
+}
+
+CompactTrie CompactTrie::build(const FlirtResult &result) {
+    CompactTrie t;
+    const QVector<FlirtTreeNode> &nodes = result.nodes;
+    if (nodes.isEmpty()) return t;
+    t.m_nodeCount = nodes.size();
+
+    // Breadth-first order over the pre-order arena
+    QVector<int> order;
+    order.reserve(nodes.size());
+    order.append(0);
+    for (int i = 0; i < order.size(); ++i)
+        order += nodes[order[i]].children;
+
+    t.m_louds.append(true);
+    t.m_louds.append(false);
+    QVector<quint32> leafModuleBegins;
+    for (int id : order) {
+        const FlirtTreeNode &node = nodes[id];
+        for (int c = 0; c < node.children.size(); ++c)
+            t.m_louds.append(true);
+        t.m_louds.append(false);
+
+        const FlirtPatternNode &p = node.pattern;
+        for (int i = 0; i < p.patternBytes.size(); ++i) {
+            t.m_lengths.append(false);
+            t.m_variant.append(i < p.variantMask.size() && p.variantMask[i]);
+        }
+        t.m_lengths.append(true);
+        t.m_labels += p.patternBytes;
+
+        const bool leaf = node.children.isEmpty();
+        t.m_leaves.append(leaf);
+        if (leaf) t.m_leafModule.append(static_cast<quint32>(node.moduleBegin));
+    }
+
+    // Leaves own contiguous module runs in DFS order; mark where each run starts
+    QVector<bool> starts(result.modules.size() + 1, false);
+    for (const FlirtTreeNode &node : nodes) {
+        if (node.children.isEmpty() && node.moduleBegin < node.moduleEnd)
+            starts[node.moduleBegin] = true;
+    }
+    starts[result.modules.size()] = true;
+    for (bool s : starts)
+        t.m_moduleStarts.append(s);
+
+    t.m_louds.finish();
+    t.m_lengths.finish();
+    t.m_variant.finish();
+    t.m_leaves.finish();
+    t.m_moduleStarts.finish();
+    t.m_labels.squeeze();
+    t.m_leafModule.squeeze();
+    return t;
+}
+
+int CompactTrie::childCount(int node) const {
+    const qsizetype begin = m_louds.select0(node);
+    const qsizetype end = m_louds.select0(node + 1);
+    return static_cast<int>(end - begin - 1);
+}
+
+int CompactTrie::firstChild(int node) const {
+    const qsizetype pos = m_louds.select0(node) + 1;
+    if (!m_louds.at(pos)) return -1;
+    return static_cast<int>(m_louds.rank1(pos));
+}
+
+int CompactTrie::parent(int node) const {
+    return static_cast<int>(m_louds.rank0(m_louds.select1(node))) - 1;
+}
+
+qsizetype CompactTrie::labelBegin(int node) const {
+    return node == 0 ? 0 : m_lengths.select1(node - 1) - (node - 1);
+}
+
+int CompactTrie::patternLength(int node) const {
+    return static_cast<int>(m_lengths.select1(node) - node - labelBegin(node));
+}
+
+void CompactTrie::patternBytes(int node, char *bytes, bool *variant) const {
+    const qsizetype begin = labelBegin(node);
+    const int n = patternLength(node);
+    for (int i = 0; i < n; ++i) {
+        bytes[i] = m_labels[begin + i];
+        variant[i] = m_variant.at(begin + i);
+    }
+}
+
+FlirtPatternNode CompactTrie::pattern(int node) const {
+    FlirtPatternNode p;
+    const qsizetype begin = labelBegin(node);
+    const int n = patternLength(node);
+    p.patternBytes = m_labels.mid(begin, n);
+    p.variantMask.resize(n);
+    for (int i = 0; i < n; ++i)
+        p.variantMask[i] = m_variant.at(begin + i) ? 1 : 0;
+    return p;
+}
+
+bool CompactTrie::matches(int node, const char *data, qsizetype size, qsizetype pos) const {
+    const qsizetype begin = labelBegin(node);
+    const int n = patternLength(node);
+    const char *labels = m_labels.constData() + begin;
+    for (int i = 0; i < n; ++i) {
+        if (m_variant.at(begin + i)) continue;
+        if (pos + i >= size || data[pos + i] != labels[i]) return false;
+    }
+    return true;
+}
+
+int CompactTrie::leafModuleBegin(int node) const {
+    if (!m_leaves.at(node)) return 0;
+    return static_cast<int>(m_leafModule[m_leaves.rank1(node)]);
+}
+
+int CompactTrie::leafModuleEnd(int node) const {
+    if (!m_leaves.at(node)) return 0;
+    const qsizetype begin = m_leafModule[m_leaves.rank1(node)];
+    return static_cast<int>(m_moduleStarts.select1(m_moduleStarts.rank1(begin) + 1));
+}
+
+qsizetype CompactTrie::memoryBytes() const {
+    return m_louds.memoryBytes() + m_lengths.memoryBytes() + m_variant.memoryBytes() + m_leaves.memoryBytes()
+         + m_moduleStarts.memoryBytes() + m_labels.size() + m_leafModule.size() * qsizetype(sizeof(quint32));
+}
+
+} // namespace SigParser
@@ -0,0 +1,83 @@
+#ifndef COMPACTTRIE_H
+#define COMPACTTRIE_H
+
+#include "flirtparser.h"
+
+namespace SigParser {
+
+// Append-only bit vector with rank and select. Rank uses one cumulative count per 512 bits;
+// select binary-searches those counts and finishes inside one 64-bit word.
+class RankSelectBits
+{
+public:
+    void append(bool bit);
+    /** Call once after the last append; rank and select are undefined before. */
+    void finish();
+
+    qsizetype size() const { return m_size; }
+    bool at(qsizetype pos) const { return (m_words[pos >> 6] >> (pos & 63)) & 1; }
+    /** Number of 1 bits in [0, pos). */
+    qsizetype rank1(qsizetype pos) const;
+    qsizetype rank0(qsizetype pos) const { return pos - rank1(pos); }
+    /** Position of the k-th (0-based) 1 or 0 bit, or -1 past the last one. */
+    qsizetype select1(qsizetype k) const;
+    qsizetype select0(qsizetype k) const;
+    qsizetype memoryBytes() const;
+
+private:
+    template <bool One>
+    qsizetype select(qsizetype k) const;
+
+    QVector<quint64> m_words;
+    QVector<quint32> m_blockRank;  // 1 bits before each 8-word block
+    qsizetype m_size = 0;
+    qsizetype m_ones = 0;
+};
+
+/**
+ * Level-order unary degree sequence (LOUDS) encoding of a signature trie. Nodes are numbered
+ * in level order with the root as 0; children of a node have consecutive ids. Pattern bytes
+ * are packed in node order with one variant bit per byte, and node lengths are unary coded.
+ * Costs about 2 bits per node plus 10 bits per pattern byte and 32 bits per leaf, against
+ * well over 100 bytes per node for FlirtResult::nodes.
+ */
+class CompactTrie
+{
+public:
+    static CompactTrie build(const FlirtResult &result);
+
+    int nodeCount() const { return m_nodeCount; }
+    int childCount(int node) const;
+    /** Id of the first child; the others follow consecutively. -1 for leaves. */
+    int firstChild(int node) const;
+    int parent(int node) const;
+    bool isLeaf(int node) const { return childCount(node) == 0; }
+
+    int patternLength(int node) const;
+    FlirtPatternNode pattern(int node) const;
+    /** Pattern bytes and variant flags of a node, written to bytes/variant (patternLength each). */
+    void patternBytes(int node, char *bytes, bool *variant) const;
+    bool matches(int node, const char *data, qsizetype size, qsizetype pos) const;
+
+    /** Module range of a leaf (FlirtResult::modules indices); empty for internal nodes. */
+    int leafModuleBegin(int node) const;
+    int leafModuleEnd(int node) const;
+
+    qsizetype memoryBytes() const;
+
+private:
+    qsizetype labelBegin(int node) const;
+
+    int m_nodeCount = 0;
+    RankSelectBits m_louds;        // "10", then 1^degree 0 per node in level order
+    RankSelectBits m_lengths;      // 0^length 1 per node
+    RankSelectBits m_variant;      // one bit per pattern byte
+    RankSelectBits m_leaves;       // one bit per node, set for leaves
+    QByteArray m_labels;           // pattern bytes of all nodes in level order
+    QVector<quint32> m_leafModule; // first module per leaf, by leaf rank
+    RankSelectBits m_moduleStarts; // one bit per module (+ end sentinel), set at each leaf's first module
+};
+
+} // namespace SigParser
+
+#endif // COMPACTTRIE_H
@@ -0,0 +1,283 @@
+#include "corpusscan.h"
+#include "binaryinfo.h"
+#include "functionexport.h"
+#include "matchcache.h"
+#include "matchconfidence.h"
+#include "overlapresolve.h"
+#include "prologuesketch.h"
+#include "sigcatalogue.h"
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+
+namespace SigParser {
+
+// Offsets handed to the matchers per call: bounds memory and keeps the slice of the image hot
+static constexpr int CORPUS_SLICE_OFFSETS = 1 << 16;
+// Part of every cache key; change it whenever the choice of starts or signatures changes
+static const char CORPUS_SCAN_OPTIONS[] = "corpus-v3:code-ranges:dex-methods";
+
+static double megabytesPerSecond(qint64 bytes, qint64 ns) {
+    return ns > 0 ? (static_cast<double>(bytes) / (1024.0 * 1024.0)) / (static_cast<double>(ns) / 1e9) : 0.0;
+}
+
+int scanAlignment(const CorpusScanOptions &options, quint8 arch) {
+    if (options.alignment > 0) return options.alignment;
+    return arch == IDASIG_ARCH_386 ? 1 : functionAlignment(arch);
+}
+
+QVector<CorpusFile> listCorpus(const QString &dir) {
+    QVector<CorpusFile> files;
+    QDirIterator it(dir, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        files.append({ it.filePath(), it.fileInfo().size() });
+    }
+    std::stable_sort(files.begin(), files.end(), [](const CorpusFile &a, const CorpusFile &b) {
+        return a.size != b.size ? a.size > b.size : a.path < b.path;
+    });
+    return files;
+}
+
+static bool cachedResultFits(const CorpusFileResult &r, const QVector<CorpusSignature> &signatures) {
+    for (const CorpusMatch &m : r.matches) {
+        if (m.signature < 0 || m.signature >= signatures.size()
+            || m.module < 0 || m.module >= signatures[m.signature].matcher->moduleCount())
+            return false;
+    }
+    return true;
+}
+
+// Raw matches to the reported ones: confidence, threshold, then overlap resolution
+static void finishMatches(CorpusFileResult &r, const QByteArray &image, const QVector<CorpusSignature> &signatures,
+                          double minConfidence) {
+    QMultiHash<qint64, QString> namesAt;
+    for (const CorpusMatch &m : r.matches) {
+        for (const FlirtFunction &f : signatures[m.signature].matcher->result().modules[m.module].publicFunctions)
+            namesAt.insert(m.offset + f.offset, f.name);
+    }
+    QVector<CorpusMatch> kept;
+    for (CorpusMatch m : r.matches) {
+        const FlirtResult &result = signatures[m.signature].matcher->result();
+        const FlirtModule &mod = result.modules[m.module];
+        const int resolved = result.header.arch == IDASIG_ARCH_386 ? resolveX86References(mod, image, m.offset, namesAt) : 0;
+        m.confidence = static_cast<float>(matchConfidence(mod, resolved));
+        if (m.confidence < minConfidence) ++r.belowThreshold;
+        else kept.append(m);
+    }
+    r.matches = resolveOverlaps(kept, signatures, &r.conflicts);
+}
+
+CorpusFileResult scanCorpusFile(const QString &path, const QVector<CorpusSignature> &signatures,
+                                const CorpusScanOptions &options, const QByteArray &signatureSetHash) {
+    MatchCache *cache = options.cache;
+    QElapsedTimer timer;
+    timer.start();
+    CorpusFileResult r;
+    r.path = path;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        r.error = "Cannot open file";
+        r.elapsedNs = timer.nsecsElapsed();
+        return r;
+    }
+    r.size = file.size();
+    QByteArray image;
+    if (r.size > 0) {
+        if (uchar *mapped = file.map(0, r.size))
+            image = QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), r.size);
+        else
+            image = file.readAll();  // e.g. special files that cannot be mapped
+    }
+    // Method names are needed for cached results too, and the walk is cheap next to matching
+    if (isDex(image)) {
+        if (parseDexMethods(image, r.methods, &r.error)) {
+            std::sort(r.methods.begin(), r.methods.end(), [](const DexMethod &a, const DexMethod &b) {
+                return a.codeOffset < b.codeOffset;
+            });
+        } else {
+            r.elapsedNs = timer.nsecsElapsed();
+            return r;
+        }
+    }
+
+    QByteArray cacheKey;
+    if (cache) {
+        const QByteArray alignment = options.alignment > 0 ? QByteArray::number(options.alignment) : QByteArray("arch");
+        cacheKey = MatchCache::key(MatchCache::contentHash(image), signatureSetHash,
+                                   QByteArray(CORPUS_SCAN_OPTIONS) + ":alignment=" + alignment);
+        if (cache->lookup(cacheKey, r) && cachedResultFits(r, signatures)) {
+            r.cached = true;
+            finishMatches(r, image, signatures, options.minConfidence);
+            r.elapsedNs = timer.nsecsElapsed();
+            return r;
+        }
+        r.matches.clear();
+    }
+
+    const BinaryInfo info = probeBinary(image);
+    r.format = info.description;
+    QVector<int> active;
+    for (int i = 0; i < signatures.size(); ++i) {
+        if (!info.isValid() || signatureIncompatibility(signatures[i].matcher->result().header, info).isEmpty())
+            active.append(i);
+    }
+    r.signaturesRun = active.size();
+
+    QVector<QPair<qint64, qint64>> ranges = info.codeRanges;
+    if (ranges.isEmpty()) ranges.append({ 0, image.size() });
+    const int alignment = scanAlignment(options, info.isValid() ? info.arch : IDASIG_ARCH_386);
+    QVector<qsizetype> slice;
+    slice.reserve(CORPUS_SLICE_OFFSETS);
+    auto flush = [&]() {
+        r.starts += slice.size();
+        for (int si : active) {
+            for (const FlirtMatcher::OffsetCandidate &c : signatures[si].matcher->matchOffsets(image, slice)) {
+                if (c.failed == FlirtMatcher::Check::None) r.matches.append({ c.offset, si, c.module });
+            }
+        }
+        slice.clear();
+    };
+    if (!active.isEmpty() && info.format == BinaryInfo::Format::Dex) {
+        qint64 previous = -1;
+        for (const DexMethod &method : r.methods) {
+            if (method.codeOffset == previous) continue;  // code_item shared by several methods
+            previous = method.codeOffset;
+            slice.append(method.codeOffset);
+            if (slice.size() == CORPUS_SLICE_OFFSETS) flush();
+        }
+        flush();
+    } else if (!active.isEmpty()) {
+        for (const QPair<qint64, qint64> &range : ranges) {
+            for (qint64 pos = (range.first + alignment - 1) / alignment * alignment; pos < range.second; pos += alignment) {
+                slice.append(pos);
+                if (slice.size() == CORPUS_SLICE_OFFSETS) flush();
+            }
+        }
+        flush();
+    }
+    std::sort(r.matches.begin(), r.matches.end(), [](const CorpusMatch &a, const CorpusMatch &b) {
+        return a.offset != b.offset ? a.offset < b.offset : a.signature < b.signature;
+    });
+    if (cache) cache->store(cacheKey, r);
+    finishMatches(r, image, signatures, options.minConfidence);
+    r.elapsedNs = timer.nsecsElapsed();
+    return r;
+}
+
+// "offset", "signature" and "module" members of a match object
+static void appendMatchFields(QByteArray &out, const CorpusMatch &m, const QVector<CorpusSignature> &signatures) {
+    out += "\"offset\":" + QByteArray::number(m.offset) + ",\"signature\":";
+    appendJsonString(out, signatures[m.signature].name.toUtf8());
+    out += ",\"module\":" + QByteArray::number(m.module);
+}
+
+const DexMethod *CorpusFileResult::methodAt(qint64 offset) const {
+    auto it = std::lower_bound(methods.cbegin(), methods.cend(), offset,
+                               [](const DexMethod &m, qint64 o) { return m.codeOffset < o; });
+    return it != methods.cend() && it->codeOffset == offset ? &*it : nullptr;
+}
+
+QByteArray CorpusFileResult::toNdjson(const QVector<CorpusSignature> &signatures) const {
+    QByteArray out = "{\"path\":";
+    appendJsonString(out, path.toUtf8());
+    out += ",\"size\":" + QByteArray::number(size) + ",\"format\":";
+    appendJsonString(out, format.toUtf8());
+    out += ",\"ms\":" + QByteArray::number(elapsedNs / 1e6, 'f', 3)
+         + ",\"mb_per_s\":" + QByteArray::number(megabytesPerSecond(size, elapsedNs), 'f', 1)
+         + ",\"starts\":" + QByteArray::number(starts)
+         + ",\"signatures\":" + QByteArray::number(signaturesRun)
+         + ",\"cached\":" + (cached ? "true" : "false");
+    if (!error.isEmpty()) {
+        out += ",\"error\":";
+        appendJsonString(out, error.toUtf8());
+    }
+    out += ",\"matches\":[";
+    for (int i = 0; i < matches.size(); ++i) {
+        out += i ? ",{" : "{";
+        appendMatchFields(out, matches[i], signatures);
+        out += ",\"confidence\":" + QByteArray::number(matches[i].confidence, 'f', 3);
+        if (const DexMethod *method = methodAt(matches[i].offset)) {
+            out += ",\"method_id\":" + QByteArray::number(method->methodId) + ",\"method\":";
+            appendJsonString(out, method->name.toUtf8());
+        }
+        const FlirtModule &mod = signatures[matches[i].signature].matcher->result().modules[matches[i].module];
+        out += ",\"names\":[";
+        for (int f = 0; f < mod.publicFunctions.size(); ++f) {
+            if (f) out += ',';
+            appendJsonString(out, mod.publicFunctions[f].name.toUtf8());
+        }
+        out += "]}";
+    }
+    out += "],\"below_threshold\":" + QByteArray::number(belowThreshold) + ",\"conflicts\":[";
+    for (int i = 0; i < conflicts.size(); ++i) {
+        out += i ? ",{" : "{";
+        appendMatchFields(out, conflicts[i].dropped, signatures);
+        out += ",\"lost_to\":{";
+        appendMatchFields(out, conflicts[i].winner, signatures);
+        out += "}}";
+    }
+    out += "]}\n";
+    return out;
+}
+
+QByteArray CorpusStats::toNdjson() const {
+    const double wallSeconds = wallNs / 1e9;
+    return "{\"summary\":{\"files\":" + QByteArray::number(files)
+         + ",\"failed\":" + QByteArray::number(failed)
+         + ",\"bytes\":" + QByteArray::number(bytes)
+         + ",\"matches\":" + QByteArray::number(matches)
+         + ",\"conflicts\":" + QByteArray::number(conflicts)
+         + ",\"below_threshold\":" + QByteArray::number(belowThreshold)
+         + ",\"cache_hits\":" + QByteArray::number(cacheHits)
+         + ",\"threads\":" + QByteArray::number(threads)
+         + ",\"wall_ms\":" + QByteArray::number(wallNs / 1e6, 'f', 1)
+         + ",\"busy_ms\":" + QByteArray::number(busyNs / 1e6, 'f', 1)
+         + ",\"mb_per_s\":" + QByteArray::number(megabytesPerSecond(bytes, wallNs), 'f', 1)
+         + ",\"files_per_s\":" + QByteArray::number(wallSeconds > 0 ? files / wallSeconds : 0.0, 'f', 1)
+         + ",\"canceled\":" + (canceled ? "true" : "false") + "}}\n";
+}
+
+CorpusStats scanCorpus(const QVector<CorpusFile> &files, const QVector<CorpusSignature> &signatures,
+                       const CorpusScanOptions &options, const std::function<bool(const CorpusFileResult &)> &onResult) {
+    QElapsedTimer timer;
+    timer.start();
+    CorpusStats stats;
+    const QByteArray setHash = options.cache ? MatchCache::signatureSetHash(signatures) : QByteArray();
+    const int threads = options.threads > 0 ? options.threads : QThread::idealThreadCount();
+    stats.threads = std::max(1, std::min<int>(threads, files.size()));
+    std::atomic<int> next{ 0 };
+    std::atomic<bool> stop{ false };
+    QMutex resultMutex;
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(stats.threads);
+    for (int t = 0; t < stats.threads; ++t) {
+        pool.start([&]() {
+            for (int i = next++; i < files.size() && !stop; i = next++) {
+                const CorpusFileResult r = scanCorpusFile(files[i].path, signatures, options, setHash);
+                QMutexLocker lock(&resultMutex);
+                ++stats.files;
+                if (!r.error.isEmpty()) ++stats.failed;
+                if (r.cached) ++stats.cacheHits;
+                stats.bytes += r.size;
+                stats.matches += r.matches.size();
+                stats.conflicts += r.conflicts.size();
+                stats.belowThreshold += r.belowThreshold;
+                stats.busyNs += r.elapsedNs;
+                if (onResult && !onResult(r)) stop = true;
+            }
+        });
+    }
+    pool.waitForDone();
+    stats.canceled = stop;
+    stats.wallNs = timer.nsecsElapsed();
+    return stats;
+}
+
+} // namespace SigParser
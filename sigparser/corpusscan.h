@@ -0,0 +1,118 @@
+#ifndef CORPUSSCAN_H
+#define CORPUSSCAN_H
+
+#include "dexfile.h"
+#include "flirtmatcher.h"
+#include <functional>
+#include <memory>
+
+namespace SigParser {
+
+class MatchCache;
+
+// A compiled signature shared read-only by all corpus workers
+struct CorpusSignature {
+    QString name;
+    std::shared_ptr<const FlirtMatcher> matcher;
+};
+
+struct CorpusFile {
+    QString path;
+    qint64 size = 0;
+};
+
+struct CorpusMatch {
+    qint64 offset = 0;
+    int signature = -1;  // index into the scanned signatures
+    int module = -1;
+    float confidence = 0.0f;  // matchConfidence() with references resolved in the binary
+};
+
+struct CorpusScanOptions {
+    int threads = 0;             // 0 = one per core
+    double minConfidence = 0.0;  // matches below are dropped before overlap resolution
+    MatchCache *cache = nullptr;
+    // Step between candidate starts in executable ranges; 0 = by architecture, which on x86 is
+    // every byte since code built for size does not pad functions to 16
+    int alignment = 0;
+};
+
+// A match dropped because its bytes overlap a match that ranked higher (see resolveOverlaps())
+struct MatchConflict {
+    CorpusMatch dropped;
+    CorpusMatch winner;
+};
+
+struct CorpusFileResult {
+    QString path;
+    qint64 size = 0;
+    QString format;          // BinaryInfo::description; empty when not recognised
+    QString error;
+    qint64 starts = 0;       // candidate function starts tried
+    int signaturesRun = 0;   // signatures compatible with the file
+    qint64 elapsedNs = 0;
+    bool cached = false;     // matches came from the MatchCache
+    QVector<CorpusMatch> matches;      // non-overlapping, by offset
+    QVector<MatchConflict> conflicts;  // overlapping matches that were dropped
+    int belowThreshold = 0;            // matches under CorpusScanOptions::minConfidence
+    QVector<DexMethod> methods;        // DEX only: methods with bytecode, by code offset
+
+    /** The DEX method whose bytecode starts at offset, or nullptr. */
+    const DexMethod *methodAt(qint64 offset) const;
+
+    /** One NDJSON line with the file's timing, throughput and matches (module names included). */
+    QByteArray toNdjson(const QVector<CorpusSignature> &signatures) const;
+};
+
+struct CorpusStats {
+    int files = 0;
+    int failed = 0;
+    qint64 bytes = 0;
+    qint64 matches = 0;
+    qint64 conflicts = 0;
+    qint64 belowThreshold = 0;
+    int cacheHits = 0;
+    int threads = 0;
+    qint64 busyNs = 0;  // per-file times summed over all workers
+    qint64 wallNs = 0;
+    bool canceled = false;
+
+    /** Closing NDJSON line: {"summary": {...}}. */
+    QByteArray toNdjson() const;
+};
+
+/**
+ * Step between candidate function starts on an IDASIG_ARCH_* processor: options.alignment when
+ * set, else every byte on x86 and functionAlignment() elsewhere.
+ */
+int scanAlignment(const CorpusScanOptions &options, quint8 arch);
+
+/** Regular files under dir (recursive), largest first. */
+QVector<CorpusFile> listCorpus(const QString &dir);
+
+/**
+ * Memory-map path and run every compatible signature at each offset of its executable sections,
+ * options.alignment apart (the whole file when the format is unknown; the start of every
+ * method's bytecode for DEX), a slice of offsets at a time so the mapped bytes stay cached
+ * across signatures. Each match then gets its confidence (x86 references resolved against the
+ * other matches), those under options.minConfidence are dropped, and overlaps are resolved with
+ * resolveOverlaps(), signatures earlier in the list taking priority. With options.cache, the
+ * file's content hash is looked up first under signatureSetHash (MatchCache::signatureSetHash
+ * of signatures) and raw results are stored.
+ */
+CorpusFileResult scanCorpusFile(const QString &path, const QVector<CorpusSignature> &signatures,
+                                const CorpusScanOptions &options = CorpusScanOptions(),
+                                const QByteArray &signatureSetHash = QByteArray());
+
+/**
+ * Scan files on a pool of options.threads workers. Each worker takes the next file of the
+ * list, so with files sorted largest first the big ones start early and the small ones fill
+ * the gaps at the end. onResult is called for every file as it finishes, one call at a time,
+ * and may return false to cancel the files not yet started.
+ */
+CorpusStats scanCorpus(const QVector<CorpusFile> &files, const QVector<CorpusSignature> &signatures,
+                       const CorpusScanOptions &options, const std::function<bool(const CorpusFileResult &)> &onResult);
+
+} // namespace SigParser
+
+#endif // CORPUSSCAN_H
@@ -0,0 +1,117 @@
+#include "dexfile.h"
+
+namespace SigParser {
+
+static constexpr int DEX_HEADER_SIZE = 0x70;
+static constexpr quint32 DEX_ENDIAN_CONSTANT = 0x12345678;
+static constexpr int DEX_CLASS_DEF_SIZE = 32;
+static constexpr int DEX_CODE_ITEM_INSNS = 16;  // insns follow a 16-byte code_item header
+
+// Bounds-checked little-endian reader; any read past the end sets ok to false
+struct DexReader {
+    const QByteArray &data;
+    bool ok = true;
+
+    quint32 u8(qint64 at) {
+        if (at < 0 || at >= data.size()) return fail();
+        return static_cast<quint8>(data[at]);
+    }
+    quint32 u16(qint64 at) { return u8(at) | (u8(at + 1) << 8); }
+    quint32 u32(qint64 at) { return u16(at) | (u16(at + 2) << 16); }
+    quint32 uleb128(qint64 &at) {
+        quint32 value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            const quint32 b = u8(at++);
+            value |= (b & 0x7f) << shift;
+            if (!(b & 0x80) || !ok) return value;
+        }
+        return fail();
+    }
+    quint32 fail() {
+        ok = false;
+        return 0;
+    }
+};
+
+bool isDex(const QByteArray &data) {
+    return data.size() >= 8 && data.startsWith("dex\n") && data[4] == '0' && data[7] == '\0';
+}
+
+static QString dexString(DexReader &r, quint32 stringIdsOff, quint32 stringCount, quint32 index) {
+    if (index >= stringCount) return QString();
+    qint64 at = r.u32(stringIdsOff + qint64(index) * 4);
+    r.uleb128(at);  // UTF-16 length
+    const qint64 begin = at;
+    while (r.ok && at < r.data.size() && r.data[at] != '\0')
+        ++at;
+    // MUTF-8 differs from UTF-8 only for NUL and supplementary characters
+    return QString::fromUtf8(r.data.constData() + begin, at - begin);
+}
+
+bool parseDexMethods(const QByteArray &data, QVector<DexMethod> &methods, QString *error) {
+    methods.clear();
+    auto fail = [error](const QString &message) {
+        if (error) *error = message;
+        return false;
+    };
+    if (!isDex(data) || data.size() < DEX_HEADER_SIZE) return fail("Not a DEX file");
+    DexReader r{ data };
+    if (r.u32(0x28) != DEX_ENDIAN_CONSTANT) return fail("Unsupported DEX byte order");
+    const quint32 stringCount = r.u32(0x38);
+    const quint32 stringIdsOff = r.u32(0x3c);
+    const quint32 typeCount = r.u32(0x40);
+    const quint32 typeIdsOff = r.u32(0x44);
+    const quint32 methodCount = r.u32(0x58);
+    const quint32 methodIdsOff = r.u32(0x5c);
+    const quint32 classCount = r.u32(0x60);
+    const quint32 classDefsOff = r.u32(0x64);
+    if (qint64(classDefsOff) + qint64(classCount) * DEX_CLASS_DEF_SIZE > data.size()
+        || qint64(methodIdsOff) + qint64(methodCount) * 8 > data.size()
+        || qint64(stringIdsOff) + qint64(stringCount) * 4 > data.size()
+        || qint64(typeIdsOff) + qint64(typeCount) * 4 > data.size())
+        return fail("DEX index tables extend past the end of the file");
+
+    auto typeName = [&](quint32 typeIdx) {
+        return typeIdx < typeCount ? dexString(r, stringIdsOff, stringCount, r.u32(typeIdsOff + qint64(typeIdx) * 4)) : QString();
+    };
+
+    for (quint32 c = 0; c < classCount && r.ok; ++c) {
+        const qint64 def = classDefsOff + qint64(c) * DEX_CLASS_DEF_SIZE;
+        const quint32 classDataOff = r.u32(def + 24);
+        if (classDataOff == 0) continue;  // marker interface or class without members
+        const QString className = typeName(r.u32(def));
+        qint64 at = classDataOff;
+        const quint32 staticFields = r.uleb128(at);
+        const quint32 instanceFields = r.uleb128(at);
+        const quint32 directMethods = r.uleb128(at);
+        const quint32 virtualMethods = r.uleb128(at);
+        for (quint32 f = 0; f < staticFields + instanceFields && r.ok; ++f) {
+            r.uleb128(at);  // field_idx_diff
+            r.uleb128(at);  // access_flags
+        }
+        // Method ids are delta-coded, restarting for the virtual methods
+        quint32 methodId = 0;
+        for (quint32 m = 0; m < directMethods + virtualMethods && r.ok; ++m) {
+            if (m == directMethods) methodId = 0;
+            methodId += r.uleb128(at);
+            r.uleb128(at);  // access_flags
+            const quint32 codeOff = r.uleb128(at);
+            if (codeOff == 0) continue;  // abstract or native
+            const qint64 insnsUnits = r.u32(codeOff + 12);
+            const qint64 codeOffset = qint64(codeOff) + DEX_CODE_ITEM_INSNS;
+            if (!r.ok || methodId >= methodCount || codeOffset + insnsUnits * 2 > data.size())
+                return fail(QString("Bad code_item for method %1").arg(methodId));
+            DexMethod method;
+            method.methodId = methodId;
+            method.codeOffset = codeOffset;
+            method.codeSize = insnsUnits * 2;
+            const qint64 mid = methodIdsOff + qint64(methodId) * 8;
+            method.name = className + "->" + dexString(r, stringIdsOff, stringCount, r.u32(mid + 4));
+            methods.append(method);
+        }
+    }
+    if (!r.ok) return fail("Truncated DEX class data");
+    return true;
+}
+
+} // namespace SigParser
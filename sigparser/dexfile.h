@@ -0,0 +1,29 @@
+#ifndef DEXFILE_H
+#define DEXFILE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+namespace SigParser {
+
+// One method with a body in a DEX file
+struct DexMethod {
+    quint32 methodId = 0;   // index into method_ids
+    qint64 codeOffset = 0;  // file offset of the code_item's insns (the bytecode)
+    qint64 codeSize = 0;    // bytes of bytecode
+    QString name;           // "Lcom/example/Foo;->bar"
+};
+
+/** True for data starting with a DEX magic ("dex\n0NN\0"). */
+bool isDex(const QByteArray &data);
+
+/**
+ * Walk class_defs and their class_data_items and list every method that has a code_item, in
+ * class order. Offsets are checked against data; a malformed file yields false and error.
+ */
+bool parseDexMethods(const QByteArray &data, QVector<DexMethod> &methods, QString *error = nullptr);
+
+} // namespace SigParser
+
+#endif // DEXFILE_H
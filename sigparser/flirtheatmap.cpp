@@ -0,0 +1,102 @@
+#include "flirtheatmap.h"
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+#include <cstring>
+
+namespace SigParser {
+
+static constexpr int HEATMAP_CHUNK_SIZE = 8192;
+// Extra row past the real table that absorbs increments for variant and absent positions
+static constexpr int HEATMAP_SINK = HEATMAP_POSITIONS * 256;
+
+double BytePositionHistogram::wildcardRate(int position) const {
+    return covered[position] ? static_cast<double>(wildcards[position]) / covered[position] : 0.0;
+}
+
+quint64 BytePositionHistogram::maxCount() const {
+    return counts.isEmpty() ? 0 : *std::max_element(counts.cbegin(), counts.cend());
+}
+
+void BytePositionHistogram::merge(const BytePositionHistogram &other) {
+    for (int i = 0; i < counts.size(); ++i)
+        counts[i] += other.counts[i];
+    for (int p = 0; p < HEATMAP_POSITIONS; ++p) {
+        wildcards[p] += other.wildcards[p];
+        covered[p] += other.covered[p];
+    }
+    moduleCount += other.moduleCount;
+}
+
+QByteArray BytePositionHistogram::toCsv() const {
+    QByteArray out = "position,covered,wildcards,wildcard_rate";
+    for (int b = 0; b < 256; ++b)
+        out += QByteArray(",") + QByteArray::number(b, 16).rightJustified(2, '0').toUpper();
+    out += '\n';
+    for (int p = 0; p < HEATMAP_POSITIONS; ++p) {
+        out += QByteArray::number(p) + ',' + QByteArray::number(covered[p]) + ','
+             + QByteArray::number(wildcards[p]) + ',' + QByteArray::number(wildcardRate(p), 'f', 4);
+        for (int b = 0; b < 256; ++b)
+            out += ',' + QByteArray::number(count(p, b));
+        out += '\n';
+    }
+    return out;
+}
+
+// Histogram kernel for one slice of modules. Each module pattern is flattened into fixed
+// 64-lane byte/mask/present arrays so that the per-position work is branch-free: the
+// counter index is computed for all lanes (variant and absent lanes point at the sink row)
+// and the wildcard/coverage sums are plain lane-wise adds the compiler vectorizes.
+static BytePositionHistogram histogramForChunk(const FlirtResult &result, int begin, int end) {
+    QVector<quint32> local(HEATMAP_SINK + 1, 0);
+    quint32 wild[HEATMAP_POSITIONS] = {};
+    quint32 present[HEATMAP_POSITIONS] = {};
+
+    for (int mi = begin; mi < end; ++mi) {
+        quint8 bytes[HEATMAP_POSITIONS] = {};
+        quint8 variant[HEATMAP_POSITIONS] = {};
+        quint8 inside[HEATMAP_POSITIONS] = {};
+        int pos = 0;
+        for (const FlirtPatternNode &n : result.modules[mi].patternPath) {
+            const int len = std::min<int>(n.patternBytes.size(), HEATMAP_POSITIONS - pos);
+            memcpy(bytes + pos, n.patternBytes.constData(), len);
+            memcpy(variant + pos, n.variantMask.constData(), std::min<int>(len, n.variantMask.size()));
+            memset(inside + pos, 1, len);
+            pos += len;
+        }
+
+        quint32 index[HEATMAP_POSITIONS];
+        for (int p = 0; p < HEATMAP_POSITIONS; ++p) {
+            const quint32 fixed = inside[p] & (variant[p] ^ 1);
+            index[p] = fixed ? static_cast<quint32>(p * 256 + bytes[p]) : HEATMAP_SINK;
+            wild[p] += inside[p] & variant[p];
+            present[p] += inside[p];
+        }
+        for (int p = 0; p < HEATMAP_POSITIONS; ++p)
+            ++local[index[p]];
+    }
+
+    BytePositionHistogram h;
+    for (int i = 0; i < HEATMAP_SINK; ++i)
+        h.counts[i] = local[i];
+    for (int p = 0; p < HEATMAP_POSITIONS; ++p) {
+        h.wildcards[p] = wild[p];
+        h.covered[p] = present[p];
+    }
+    h.moduleCount = end - begin;
+    return h;
+}
+
+BytePositionHistogram computeBytePositionHistogram(const FlirtResult &result) {
+    const int modules = result.modules.size();
+    QVector<int> chunkStarts;
+    for (int i = 0; i < modules; i += HEATMAP_CHUNK_SIZE)
+        chunkStarts.append(i);
+    return QtConcurrent::blockingMappedReduced<BytePositionHistogram>(
+        chunkStarts,
+        [&result, modules](int begin) {
+            return histogramForChunk(result, begin, std::min(begin + HEATMAP_CHUNK_SIZE, modules));
+        },
+        [](BytePositionHistogram &acc, const BytePositionHistogram &part) { acc.merge(part); });
+}
+
+} // namespace SigParser
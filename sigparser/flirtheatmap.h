@@ -0,0 +1,30 @@
+#ifndef FLIRTHEATMAP_H
+#define FLIRTHEATMAP_H
+
+#include "flirtparser.h"
+
+namespace SigParser {
+
+constexpr int HEATMAP_POSITIONS = 64;  // longest pattern a FLIRT node path can describe
+
+// Fixed byte values seen at each pattern position across all modules
+struct BytePositionHistogram {
+    QVector<quint64> counts = QVector<quint64>(HEATMAP_POSITIONS * 256, 0);  // [position * 256 + byte]
+    QVector<quint64> wildcards = QVector<quint64>(HEATMAP_POSITIONS, 0);     // variant bytes per position
+    QVector<quint64> covered = QVector<quint64>(HEATMAP_POSITIONS, 0);       // modules whose pattern reaches the position
+    quint64 moduleCount = 0;
+
+    quint64 count(int position, int byte) const { return counts[position * 256 + byte]; }
+    double wildcardRate(int position) const;
+    quint64 maxCount() const;
+    void merge(const BytePositionHistogram &other);
+    /** One CSV line per position: position, covered, wildcards, wildcard_rate, then the 256 byte counts. */
+    QByteArray toCsv() const;
+};
+
+/** Build the 64 x 256 histogram over all module patterns in parallel. Safe to call off the GUI thread. */
+BytePositionHistogram computeBytePositionHistogram(const FlirtResult &result);
+
+} // namespace SigParser
+
+#endif // FLIRTHEATMAP_H
@@ -0,0 +1,459 @@
+#include "flirtmatcher.h"
+#include <QRegularExpression>
+#include <QStringList>
+#include <QVarLengthArray>
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <iterator>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+namespace SigParser {
+
+static constexpr quint16 FLIRT_CRC_POLY = 0x8408;
+
+static std::array<quint16, 256> makeCrcTable() {
+    std::array<quint16, 256> table{};
+    for (int b = 0; b < 256; ++b) {
+        quint16 crc = static_cast<quint16>(b);
+        for (int i = 0; i < 8; ++i)
+            crc = (crc & 1) ? static_cast<quint16>((crc >> 1) ^ FLIRT_CRC_POLY) : static_cast<quint16>(crc >> 1);
+        table[b] = crc;
+    }
+    return table;
+}
+
+quint16 flirtCrc16(const char *data, qsizetype length) {
+    static const std::array<quint16, 256> table = makeCrcTable();
+    if (length <= 0) return 0;
+    quint16 crc = 0xffff;
+    for (qsizetype i = 0; i < length; ++i)
+        crc = static_cast<quint16>((crc >> 8) ^ table[(crc ^ static_cast<quint8>(data[i])) & 0xff]);
+    crc = static_cast<quint16>(~crc);
+    return static_cast<quint16>((crc << 8) | (crc >> 8));
+}
+
+static bool isHexToken(const QString &token) {
+    if (token.isEmpty() || token.size() % 2 != 0) return false;
+    for (QChar c : token) {
+        if (!std::isxdigit(static_cast<unsigned char>(c.toLatin1()))) return false;
+    }
+    return true;
+}
+
+QByteArray parseHexDump(const QString &text, QString *error) {
+    QByteArray out;
+    const QStringList lines = text.split('\n');
+    for (QString line : lines) {
+        const int bar = line.indexOf('|');
+        if (bar >= 0) line.truncate(bar);
+        QStringList tokens = line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+        // Leading address column: "00401000:" or a wide number followed by single bytes
+        if (!tokens.isEmpty()
+            && (tokens.first().endsWith(':') || (tokens.size() > 1 && tokens[0].size() > 4 && tokens[1].size() == 2)))
+            tokens.removeFirst();
+        for (const QString &token : tokens) {
+            // xxd groups bytes in fours; anything that is not hex starts the ASCII column
+            if (!isHexToken(token)) break;
+            out += QByteArray::fromHex(token.toLatin1());
+        }
+    }
+    if (out.isEmpty() && error) *error = "No hex bytes found";
+    return out;
+}
+
+static inline void prefetchRead(const void *p) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char *>(p), _MM_HINT_T0);
+#else
+    Q_UNUSED(p);
+#endif
+}
+
+// Placement order of the flat nodes (FlirtResult::nodes indices, root first). With a profile,
+// visited nodes come first in a pre-order that follows the child whose pattern passed most
+// often first, then the rest in file order. Visits cannot rank siblings: every child of a node
+// is visited exactly as often as its parent's pattern passed.
+static QVector<int> flatNodeOrder(const FlirtResult &result, const MatchProfile *profile) {
+    const int n = result.nodes.size();
+    QVector<int> order;
+    order.reserve(n);
+    if (!profile) {
+        for (int i = 0; i < n; ++i)
+            order.append(i);
+        return order;
+    }
+    const QVector<quint64> &visits = profile->nodeVisits;
+    const QVector<quint64> &passes = profile->nodePasses;
+    QVector<bool> placed(n, false);
+    QVector<int> stack;
+    stack.append(0);
+    while (!stack.isEmpty()) {
+        const int id = stack.takeLast();
+        order.append(id);
+        placed[id] = true;
+        QVector<int> hot;
+        for (int child : result.nodes[id].children) {
+            if (visits[child]) hot.append(child);
+        }
+        std::stable_sort(hot.begin(), hot.end(), [&passes](int a, int b) { return passes[a] < passes[b]; });
+        stack += hot;  // hottest ends up on top
+    }
+    for (int i = 0; i < n; ++i) {
+        if (!placed[i]) order.append(i);
+    }
+    return order;
+}
+
+FlirtMatcher FlirtMatcher::compile(const FlirtResult &result, Encoding encoding, const MatchProfile *profile) {
+    FlirtMatcher m;
+    m.m_result = result;
+    m.m_filter = std::make_shared<const PrologueFilter>(PrologueFilter::build(result));
+    if (encoding == Encoding::Compact
+        || (encoding == Encoding::Auto && result.nodes.size() >= COMPACT_TRIE_MIN_NODES)) {
+        m.m_compact = std::make_shared<const CompactTrie>(CompactTrie::build(result));
+        // The trie now holds every pattern byte; keep only the per-module summaries so that
+        // once the caller drops its result, the node arena and the pattern paths are freed
+        m.m_result.nodes = QVector<FlirtTreeNode>();
+        for (FlirtModule &mod : m.m_result.modules)
+            mod.patternPath = QVector<FlirtPatternNode>();
+        return m;
+    }
+    if (profile && (!profile->fits(result) || profile->isEmpty())) profile = nullptr;
+    const QVector<int> order = flatNodeOrder(result, profile);
+    QVector<int> flatIndex(result.nodes.size());
+    for (int i = 0; i < order.size(); ++i)
+        flatIndex[order[i]] = i;
+
+    m.m_nodes.reserve(order.size());
+    m.m_nodeIds.reserve(order.size());
+    for (int id : order) {
+        const FlirtTreeNode &node = result.nodes[id];
+        const FlirtPatternNode &p = node.pattern;
+        FlatNode f;
+        f.patternBegin = static_cast<qint32>(m.m_patterns.size());
+        f.patternLength = static_cast<qint32>(p.patternBytes.size());
+        f.childBegin = static_cast<qint32>(m.m_children.size());
+        QVector<int> children = node.children;
+        if (profile) {
+            const QVector<quint64> &passes = profile->nodePasses;
+            std::stable_sort(children.begin(), children.end(), [&passes](int a, int b) { return passes[a] > passes[b]; });
+        }
+        for (int child : children)
+            m.m_children.append(flatIndex[child]);
+        f.childEnd = static_cast<qint32>(m.m_children.size());
+        if (node.children.isEmpty()) {
+            f.moduleBegin = node.moduleBegin;
+            f.moduleEnd = node.moduleEnd;
+        }
+        m.m_patterns += p.patternBytes;
+        QByteArray mask = p.variantMask.left(p.patternBytes.size());
+        mask.append(p.patternBytes.size() - mask.size(), '\0');
+        m.m_patterns += mask;
+        m.m_nodes.append(f);
+        m.m_nodeIds.append(id);
+    }
+    return m;
+}
+
+MatchProfile *FlirtMatcher::recorder(MatchProfile *profile) const {
+    if (!profile || profile->moduleHits.size() != m_result.modules.size()) return nullptr;
+    if (!m_compact && (profile->nodeVisits.size() != m_nodes.size() || profile->nodePasses.size() != m_nodes.size()))
+        return nullptr;
+    return profile;
+}
+
+qsizetype FlirtMatcher::trieMemoryBytes() const {
+    if (m_compact) return m_compact->memoryBytes();
+    return m_nodes.size() * qsizetype(sizeof(FlatNode)) + m_children.size() * qsizetype(sizeof(qint32)) + m_patterns.size();
+}
+
+FlirtMatcher::Check FlirtMatcher::checkModule(const FlirtModule &mod, const char *data, qsizetype size, int patternLength) const {
+    const qsizetype crcEnd = static_cast<qsizetype>(patternLength) + mod.crcLength;
+    if (mod.crcLength > 0) {
+        if (crcEnd > size) return Check::Crc;
+        if (flirtCrc16(data + patternLength, mod.crcLength) != mod.crc16) return Check::Crc;
+    }
+    if (size < static_cast<qsizetype>(mod.length)) return Check::Length;
+    for (const FlirtTailByte &tb : mod.tailBytes) {
+        const qsizetype at = crcEnd + tb.offset;
+        if (at >= size || static_cast<quint8>(data[at]) != tb.value) return Check::TailBytes;
+    }
+    return Check::None;
+}
+
+bool FlirtMatcher::flatNodeMatches(const FlatNode &node, const char *data, qsizetype size, int pos) const {
+    const char *pattern = m_patterns.constData() + node.patternBegin;
+    const char *mask = pattern + node.patternLength;
+    for (int i = 0; i < node.patternLength; ++i) {
+        if (mask[i]) continue;
+        // Bytes past the end of data only match variant (padding) positions
+        if (pos + i >= size || data[pos + i] != pattern[i]) return false;
+    }
+    return true;
+}
+
+void FlirtMatcher::matchFlat(const char *data, qsizetype size, QVector<Frame> &stack, QVector<Candidate> &out,
+                             MatchProfile *profile) const {
+    stack.clear();
+    stack.append({ 0, 0 });
+    while (!stack.isEmpty()) {
+        const Frame f = stack.takeLast();
+        const FlatNode &node = m_nodes[f.node];
+        if (profile) ++profile->nodeVisits[m_nodeIds[f.node]];
+        if (!flatNodeMatches(node, data, size, f.pos)) continue;
+        if (profile) ++profile->nodePasses[m_nodeIds[f.node]];
+        const int pos = f.pos + node.patternLength;
+        for (int c = node.childEnd - 1; c >= node.childBegin; --c)
+            stack.append({ m_children[c], pos });
+        for (int mi = node.moduleBegin; mi < node.moduleEnd; ++mi) {
+            const Check failed = checkModule(m_result.modules[mi], data, size, pos);
+            if (profile && failed == Check::None) ++profile->moduleHits[mi];
+            out.append({ mi, failed });
+        }
+    }
+}
+
+void FlirtMatcher::matchCompact(const char *data, qsizetype size, QVector<Candidate> &out, MatchProfile *profile) const {
+    const CompactTrie &trie = *m_compact;
+    if (trie.nodeCount() == 0) return;
+    QVector<Frame> stack;
+    stack.append({ 0, 0 });
+    while (!stack.isEmpty()) {
+        const Frame f = stack.takeLast();
+        if (!trie.matches(f.node, data, size, f.pos)) continue;
+        const int pos = f.pos + trie.patternLength(f.node);
+        const int first = trie.firstChild(f.node);
+        if (first >= 0) {
+            for (int c = first + trie.childCount(f.node) - 1; c >= first; --c)
+                stack.append({ c, pos });
+            continue;
+        }
+        for (int mi = trie.leafModuleBegin(f.node); mi < trie.leafModuleEnd(f.node); ++mi) {
+            const Check failed = checkModule(m_result.modules[mi], data, size, pos);
+            if (profile && failed == Check::None) ++profile->moduleHits[mi];
+            out.append({ mi, failed });
+        }
+    }
+}
+
+QVector<FlirtMatcher::Candidate> FlirtMatcher::match(const QByteArray &data, MatchProfile *profile) const {
+    QVector<Candidate> out;
+    if (m_filter && !m_filter->mayMatch(data.constData(), data.size())) return out;
+    profile = recorder(profile);
+    if (m_compact) {
+        matchCompact(data.constData(), data.size(), out, profile);
+    } else if (!m_nodes.isEmpty()) {
+        QVector<Frame> stack;
+        matchFlat(data.constData(), data.size(), stack, out, profile);
+    }
+    return out;
+}
+
+QVector<FlirtMatcher::PatternMiss> FlirtMatcher::patternNearMisses(const QByteArray &data, int maxMismatches,
+                                                                   int limit) const {
+    struct MissFrame {
+        int node;
+        int pos;
+        int mismatches;
+        int firstMismatch;
+    };
+    QVector<PatternMiss> out;
+    if (m_compact ? m_compact->nodeCount() == 0 : m_nodes.isEmpty()) return out;
+    const char *bytes = data.constData();
+    const qsizetype size = data.size();
+    QVarLengthArray<char, 64> compactPattern;
+    QVarLengthArray<bool, 64> compactVariant;
+    QVector<MissFrame> stack;
+    stack.append({ 0, 0, 0, -1 });
+    while (!stack.isEmpty() && out.size() < limit) {
+        MissFrame f = stack.takeLast();
+        int length;
+        if (m_compact) {
+            length = m_compact->patternLength(f.node);
+            compactPattern.resize(length);
+            compactVariant.resize(length);
+            m_compact->patternBytes(f.node, compactPattern.data(), compactVariant.data());
+        } else {
+            length = m_nodes[f.node].patternLength;
+        }
+        const char *pattern = m_compact ? compactPattern.constData() : m_patterns.constData() + m_nodes[f.node].patternBegin;
+        for (int i = 0; i < length && f.mismatches <= maxMismatches; ++i) {
+            if (m_compact ? compactVariant[i] : pattern[length + i] != 0) continue;
+            const qsizetype at = f.pos + i;
+            if (at < size && bytes[at] == pattern[i]) continue;
+            if (f.firstMismatch < 0) f.firstMismatch = static_cast<int>(at);
+            ++f.mismatches;
+        }
+        if (f.mismatches > maxMismatches) continue;
+        const int pos = f.pos + length;
+        int moduleBegin = 0;
+        int moduleEnd = 0;
+        if (m_compact) {
+            const int first = m_compact->firstChild(f.node);
+            for (int c = first + m_compact->childCount(f.node) - 1; first >= 0 && c >= first; --c)
+                stack.append({ c, pos, f.mismatches, f.firstMismatch });
+            moduleBegin = m_compact->leafModuleBegin(f.node);
+            moduleEnd = m_compact->leafModuleEnd(f.node);
+        } else {
+            const FlatNode &node = m_nodes[f.node];
+            for (int c = node.childEnd - 1; c >= node.childBegin; --c)
+                stack.append({ m_children[c], pos, f.mismatches, f.firstMismatch });
+            moduleBegin = node.moduleBegin;
+            moduleEnd = node.moduleEnd;
+        }
+        if (f.mismatches == 0) continue;
+        for (int mi = moduleBegin; mi < moduleEnd && out.size() < limit; ++mi)
+            out.append({ mi, f.mismatches, f.firstMismatch });
+    }
+    return out;
+}
+
+QVector<FlirtMatcher::OffsetCandidate> FlirtMatcher::matchOffsets(const QByteArray &image, const QVector<qsizetype> &offsets,
+                                                                  int batch, MatchProfile *profile) const {
+    QVector<OffsetCandidate> out;
+    if (!m_compact && m_nodes.isEmpty()) return out;
+    profile = recorder(profile);
+    const QVector<qsizetype> kept = m_filter ? m_filter->filterOffsets(image, offsets) : offsets;
+    if (!m_compact && batch > 1) {
+        matchOffsetsBatched(image, kept, batch, out, profile);
+        return out;
+    }
+    QVector<Frame> stack;
+    QVector<Candidate> found;
+    for (qsizetype offset : kept) {
+        if (offset < 0 || offset >= image.size()) continue;
+        found.clear();
+        const char *data = image.constData() + offset;
+        const qsizetype size = image.size() - offset;
+        if (m_compact)
+            matchCompact(data, size, found, profile);
+        else
+            matchFlat(data, size, stack, found, profile);
+        for (const Candidate &c : found)
+            out.append({ offset, c.module, c.failed });
+    }
+    return out;
+}
+
+// Asynchronous memory-access chaining: every lane walks one offset as a small state machine.
+// Fetch pops the next frame and prefetches its node record; Load reads the record and
+// prefetches the pattern bytes and the data they are compared with; Compare does the work
+// that is now (likely) in cache. Between two stages of one lane, all other lanes advance.
+void FlirtMatcher::matchOffsetsBatched(const QByteArray &image, const QVector<qsizetype> &offsets, int batch,
+                                       QVector<OffsetCandidate> &out, MatchProfile *profile) const {
+    enum class Stage { Fetch, Load, Compare };
+    struct Lane {
+        int input = -1;
+        Stage stage = Stage::Fetch;
+        Frame frame{ 0, 0 };
+        QVector<Frame> stack;
+        QVector<OffsetCandidate> found;  // reused for every input the lane walks
+    };
+    // Where each input's candidates landed in out; lanes finish inputs out of order
+    struct Span {
+        int input;
+        qsizetype begin;
+        qsizetype end;
+    };
+    QVector<Lane> lanes(batch);
+    QVector<Span> spans;
+    const qsizetype outBase = out.size();
+    int nextInput = 0;
+    auto refill = [&](Lane &lane) {
+        if (lane.input >= 0 && !lane.found.isEmpty()) {
+            spans.append({ lane.input, out.size(), out.size() + lane.found.size() });
+            out += lane.found;
+            lane.found.clear();
+        }
+        lane.input = -1;
+        while (nextInput < offsets.size()) {
+            const int input = nextInput++;
+            if (offsets[input] < 0 || offsets[input] >= image.size()) continue;
+            lane.input = input;
+            lane.stage = Stage::Fetch;
+            lane.stack.clear();
+            lane.stack.append({ 0, 0 });
+            return true;
+        }
+        return false;
+    };
+    int active = 0;
+    for (Lane &lane : lanes) {
+        if (refill(lane)) ++active;
+    }
+    const char *patterns = m_patterns.constData();
+    while (active > 0) {
+        for (Lane &lane : lanes) {
+            if (lane.input < 0) continue;
+            const qsizetype offset = offsets[lane.input];
+            const char *data = image.constData() + offset;
+            const qsizetype size = image.size() - offset;
+            switch (lane.stage) {
+            case Stage::Fetch:
+                if (lane.stack.isEmpty()) {
+                    if (!refill(lane)) --active;
+                    break;
+                }
+                lane.frame = lane.stack.takeLast();
+                prefetchRead(&m_nodes[lane.frame.node]);
+                lane.stage = Stage::Load;
+                break;
+            case Stage::Load: {
+                const FlatNode &node = m_nodes[lane.frame.node];
+                if (node.patternLength > 0) {
+                    prefetchRead(patterns + node.patternBegin);
+                    prefetchRead(patterns + node.patternBegin + 2 * node.patternLength - 1);
+                }
+                if (lane.frame.pos < size) prefetchRead(data + lane.frame.pos);
+                if (node.childBegin < node.childEnd) prefetchRead(&m_children[node.childBegin]);
+                lane.stage = Stage::Compare;
+                break;
+            }
+            case Stage::Compare: {
+                const FlatNode &node = m_nodes[lane.frame.node];
+                lane.stage = Stage::Fetch;
+                if (profile) ++profile->nodeVisits[m_nodeIds[lane.frame.node]];
+                if (!flatNodeMatches(node, data, size, lane.frame.pos)) break;
+                if (profile) ++profile->nodePasses[m_nodeIds[lane.frame.node]];
+                const int pos = lane.frame.pos + node.patternLength;
+                for (int c = node.childEnd - 1; c >= node.childBegin; --c)
+                    lane.stack.append({ m_children[c], pos });
+                for (int mi = node.moduleBegin; mi < node.moduleEnd; ++mi) {
+                    const Check failed = checkModule(m_result.modules[mi], data, size, pos);
+                    if (profile && failed == Check::None) ++profile->moduleHits[mi];
+                    lane.found.append({ offset, mi, failed });
+                }
+                break;
+            }
+            }
+        }
+    }
+    // Restore the input order with one copy, and only when lanes actually overtook each other
+    auto byInput = [](const Span &a, const Span &b) { return a.input < b.input; };
+    if (std::is_sorted(spans.cbegin(), spans.cend(), byInput)) return;
+    std::sort(spans.begin(), spans.end(), byInput);
+    QVector<OffsetCandidate> ordered;
+    ordered.reserve(out.size() - outBase);
+    for (const Span &span : spans)
+        std::copy(out.cbegin() + span.begin, out.cbegin() + span.end, std::back_inserter(ordered));
+    std::copy(ordered.cbegin(), ordered.cend(), out.begin() + outBase);
+}
+
+QString FlirtMatcher::checkName(Check check) {
+    switch (check) {
+    case Check::None: return "Match";
+    case Check::Pattern: return "Pattern";
+    case Check::Crc: return "CRC16";
+    case Check::Length: return "Length";
+    case Check::TailBytes: return "Tail bytes";
+    }
+    return QString();
+}
+
+} // namespace SigParser
@@ -0,0 +1,131 @@
+#ifndef FLIRTMATCHER_H
+#define FLIRTMATCHER_H
+
+#include "compacttrie.h"
+#include "matchprofile.h"
+#include "prologuefilter.h"
+#include <memory>
+
+namespace SigParser {
+
+/** FLIRT CRC16 (reflected polynomial 0x8408, byte-swapped complement; as in radare2 flirt.c). */
+quint16 flirtCrc16(const char *data, qsizetype length);
+
+/**
+ * Parse pasted hex: plain "55 8B EC ..." or dump lines with a leading address
+ * ("00401000: 55 8b ec" / "00401000  55 8b ec") and a trailing ASCII column.
+ */
+QByteArray parseHexDump(const QString &text, QString *error = nullptr);
+
+// One signature's trie flattened into contiguous arrays for repeated matching
+class FlirtMatcher
+{
+public:
+    // Checks in the order they are applied; None means the module matched
+    enum class Check { None, Pattern, Crc, Length, TailBytes };
+    struct Candidate {
+        int module = -1;
+        Check failed = Check::None;
+    };
+
+    // How the trie is held while matching. Auto picks Compact above COMPACT_TRIE_MIN_NODES nodes,
+    // trading slower navigation for a much smaller footprint, and drops the node arena and the
+    // modules' pattern paths (patternLength and patternFixedBytes remain).
+    enum class Encoding { Auto, Flat, Compact };
+    static constexpr int COMPACT_TRIE_MIN_NODES = 1 << 19;
+
+    /**
+     * With a profile recorded on the same signature, the flat encoding places visited nodes first,
+     * hottest paths contiguous, and orders each node's children by pattern passes, most first.
+     * Candidates are then reported in that child order rather than file order.
+     */
+    static FlirtMatcher compile(const FlirtResult &result, Encoding encoding = Encoding::Auto,
+                                const MatchProfile *profile = nullptr);
+
+    /**
+     * Run the trie pattern against data (which must start at the function entry), then CRC16,
+     * module length and tail bytes for each module under a matching leaf. Every such module is
+     * returned with its first failing check; modules rejected by the pattern are not listed.
+     */
+    QVector<Candidate> match(const QByteArray &data, MatchProfile *profile = nullptr) const;
+
+    // A module whose trie pattern differs from data in a few fixed bytes
+    struct PatternMiss {
+        int module = -1;
+        int mismatches = 0;     // fixed pattern bytes that differ or lie past the end of data
+        int firstMismatch = 0;  // data offset of the first one
+    };
+    /**
+     * Modules whose pattern misses data by 1 to maxMismatches fixed bytes, found by walking the
+     * trie with a mismatch budget; at most limit are returned. Exact pattern matches are left to
+     * match(), and the prologue filter is not consulted.
+     */
+    QVector<PatternMiss> patternNearMisses(const QByteArray &data, int maxMismatches, int limit) const;
+
+    // A candidate function start inside a larger image, and one module that reached the checks
+    struct OffsetCandidate {
+        qsizetype offset = 0;
+        int module = -1;
+        Check failed = Check::None;
+    };
+    /**
+     * match() at every offset of image, grouped by offset in input order. With batch > 1 the flat
+     * trie is walked for batch offsets in lockstep: each step prefetches the next node of one
+     * offset and then moves on to the others, so cache misses overlap instead of serialising.
+     * The compact encoding always walks one offset at a time. When profile is given (sized with
+     * MatchProfile::forResult), node visits, pattern passes and full module matches are added
+     * to it; the compact encoding records module matches only. Offsets the prologue filter
+     * rejects are dropped before any walk and are not recorded.
+     */
+    QVector<OffsetCandidate> matchOffsets(const QByteArray &image, const QVector<qsizetype> &offsets, int batch = 16,
+                                          MatchProfile *profile = nullptr) const;
+
+    /** Result the matcher was built from; nodes and module pattern paths are empty when compact. */
+    const FlirtResult &result() const { return m_result; }
+    bool isCompact() const { return m_compact != nullptr; }
+    /** Bloom filter over module prologues, consulted before every trie walk; nullptr before compile(). */
+    const PrologueFilter *prologueFilter() const { return m_filter.get(); }
+    /** Bytes held by the trie encoding (not counting the modules). */
+    qsizetype trieMemoryBytes() const;
+    /** FlirtResult::nodes index of each flat node in placement order; empty when compact. */
+    const QVector<qint32> &nodeLayout() const { return m_nodeIds; }
+    int moduleCount() const { return m_result.modules.size(); }
+    static QString checkName(Check check);
+
+private:
+    // One trie node of the flat encoding; a single cache line holds a few of them
+    struct FlatNode {
+        qint32 patternBegin = 0;  // m_patterns offset: length pattern bytes, then length mask bytes
+        qint32 patternLength = 0;
+        qint32 childBegin = 0;    // m_children range
+        qint32 childEnd = 0;
+        qint32 moduleBegin = 0;   // leaf module range, empty for internal nodes
+        qint32 moduleEnd = 0;
+    };
+    struct Frame {
+        int node;
+        int pos;  // data bytes consumed before this node
+    };
+
+    Check checkModule(const FlirtModule &mod, const char *data, qsizetype size, int patternLength) const;
+    bool flatNodeMatches(const FlatNode &node, const char *data, qsizetype size, int pos) const;
+    /** profile, or nullptr when it does not line up with this matcher. */
+    MatchProfile *recorder(MatchProfile *profile) const;
+    void matchFlat(const char *data, qsizetype size, QVector<Frame> &stack, QVector<Candidate> &out,
+                   MatchProfile *profile) const;
+    void matchCompact(const char *data, qsizetype size, QVector<Candidate> &out, MatchProfile *profile) const;
+    void matchOffsetsBatched(const QByteArray &image, const QVector<qsizetype> &offsets, int batch,
+                             QVector<OffsetCandidate> &out, MatchProfile *profile) const;
+
+    FlirtResult m_result;           // shares module data with the caller's copy
+    QVector<FlatNode> m_nodes;
+    QVector<qint32> m_nodeIds;      // FlirtResult::nodes index per flat node
+    QVector<qint32> m_children;
+    QByteArray m_patterns;
+    std::shared_ptr<const CompactTrie> m_compact;  // replaces the flat arrays when set
+    std::shared_ptr<const PrologueFilter> m_filter;
+};
+
+} // namespace SigParser
+
+#endif // FLIRTMATCHER_H
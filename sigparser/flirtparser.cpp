@@ -1,6 +1,7 @@
 #include "flirtparser.h"
 #include <QDataStream>
 #include <QBuffer>
+#include <QFile>
 #if HAVE_ZLIB
 #include <zlib.h>
 #endif
@@ -34,6 +35,9 @@ static QByteArray decompressZlib(const QByteArray &compressed, int windowBits) {
 }
 #endif
 
+// First progressive batch is small so the first screen of rows shows up quickly
+static constexpr int FIRST_MODULE_BATCH = 256;
+
 static quint8 readByte(ParseState &st) {
     if (st.eof || st.err || st.pos >= st.body.size()) {
         st.eof = (st.pos >= st.body.size());
@@ -204,22 +208,6 @@ bool FlirtParser::parseHeader(ParseState &st, FlirtResult &result) {
     return true;
 }
 
-quint8 FlirtParser::readByte(ParseState &st) {
-    return ::SigParser::readByte(st);
-}
-
-quint16 FlirtParser::readShortBE(ParseState &st) {
-    return ::SigParser::readShortBE(st);
-}
-
-quint16 FlirtParser::readMax2Bytes(ParseState &st) {
-    return ::SigParser::readMax2Bytes(st);
-}
-
-quint32 FlirtParser::readMultipleBytes(ParseState &st) {
-    return ::SigParser::readMultipleBytes(st);
-}
-
 bool FlirtParser::readNodeLength(ParseState &st, quint8 &len) {
     if (st.eof || st.err) return false;
     len = readByte(st);
@@ -342,7 +330,15 @@ bool FlirtParser::readModuleReferencedFunctions(ParseState &st, FlirtModule &mod
     return true;
 }
 
-bool FlirtParser::parseLeaf(ParseState &st, const QVector<FlirtPatternNode> &path, QVector<FlirtModule> &modulesOut) {
+bool FlirtParser::parseLeaf(ParseState &st, int nodeIndex, const QVector<FlirtPatternNode> &path, QVector<FlirtModule> &modulesOut) {
+    int patternLength = 0;
+    int patternFixedBytes = 0;
+    for (const FlirtPatternNode &node : path) {
+        patternLength += node.patternBytes.size();
+        for (int i = 0; i < node.patternBytes.size(); ++i) {
+            if (i >= node.variantMask.size() || !node.variantMask[i]) ++patternFixedBytes;
+        }
+    }
     quint8 flags = 0;
     do {
         quint8 crcLength = readByte(st);
@@ -351,7 +347,11 @@ bool FlirtParser::parseLeaf(ParseState &st, const QVector<FlirtPatternNode> &pat
         if (st.eof || st.err) return false;
         do {
             FlirtModule mod;
+            mod.bodyBegin = st.pos;
             mod.patternPath = path;
+            mod.patternLength = patternLength;
+            mod.patternFixedBytes = patternFixedBytes;
+            mod.leafNode = nodeIndex;
             mod.crcLength = crcLength;
             mod.crc16 = crc16;
             if (st.version >= 9) {
@@ -368,22 +368,34 @@ bool FlirtParser::parseLeaf(ParseState &st, const QVector<FlirtPatternNode> &pat
             if (flags & IDASIG_PARSE_READ_REFERENCED_FUNCTIONS) {
                 if (!readModuleReferencedFunctions(st, mod)) return false;
             }
+            mod.bodyEnd = st.pos;
+            st.functionCount += mod.publicFunctions.size();
             modulesOut.append(mod);
+            if (!publishModules(modulesOut, false)) {
+                st.canceled = true;
+                return false;
+            }
         } while (flags & IDASIG_PARSE_MORE_MODULES_WITH_SAME_CRC);
     } while (flags & IDASIG_PARSE_MORE_MODULES);
     return true;
 }
 
-bool FlirtParser::parseTree(ParseState &st, FlirtResult &result, QVector<FlirtPatternNode> &path, QVector<FlirtModule> &modulesOut) {
+bool FlirtParser::parseTree(ParseState &st, FlirtResult &result, int nodeIndex, QVector<FlirtPatternNode> &path, QVector<FlirtModule> &modulesOut) {
     quint32 treeNodes = readMultipleBytes(st);
     if (st.eof || st.err) {
         result.errorMessage = "Unexpected EOF in tree";
         return false;
     }
+    result.nodes[nodeIndex].moduleBegin = modulesOut.size();
+    result.nodes[nodeIndex].functionBegin = st.functionCount;
     if (treeNodes == 0) {
-        return parseLeaf(st, path, modulesOut);
+        if (!parseLeaf(st, nodeIndex, path, modulesOut)) return false;
+        result.nodes[nodeIndex].moduleEnd = modulesOut.size();
+        result.nodes[nodeIndex].functionEnd = st.functionCount;
+        return true;
     }
     for (quint32 i = 0; i < treeNodes; ++i) {
+        const qsizetype nodeBegin = st.pos;
         quint8 nodeLen;
         if (!readNodeLength(st, nodeLen)) return false;
         quint64 variantMask;
@@ -391,15 +403,44 @@ bool FlirtParser::parseTree(ParseState &st, FlirtResult &result, QVector<FlirtPa
         FlirtPatternNode node;
         if (!readNodeBytes(st, nodeLen, variantMask, node)) return false;
 
+        FlirtTreeNode treeNode;
+        treeNode.parent = nodeIndex;
+        treeNode.depth = result.nodes[nodeIndex].depth + 1;
+        treeNode.pattern = node;
+        treeNode.bodyBegin = nodeBegin;
+        treeNode.bodyEnd = st.pos;
+        const int childIndex = result.nodes.size();
+        result.nodes.append(treeNode);
+        result.nodes[nodeIndex].children.append(childIndex);
+
         QVector<FlirtPatternNode> childPath = path;
         childPath.append(node);
-        if (!parseTree(st, result, childPath, modulesOut)) return false;
+        if (!parseTree(st, result, childIndex, childPath, modulesOut)) return false;
     }
+    result.nodes[nodeIndex].moduleEnd = modulesOut.size();
+    result.nodes[nodeIndex].functionEnd = st.functionCount;
     return true;
 }
 
+void FlirtParser::setModuleBatchCallback(ModuleBatchCallback callback, int maxBatch) {
+    m_batchCallback = std::move(callback);
+    m_maxBatch = qMax(1, maxBatch);
+}
+
+bool FlirtParser::publishModules(const QVector<FlirtModule> &modules, bool flush) {
+    if (!m_batchCallback) return true;
+    const qsizetype pending = modules.size() - m_published;
+    if (pending <= 0 || (!flush && pending < m_nextBatch)) return true;
+    const bool keepGoing = m_batchCallback(modules.mid(m_published, pending));
+    m_published = modules.size();
+    m_nextBatch = qMin(m_nextBatch * 2, m_maxBatch);
+    return keepGoing;
+}
+
 FlirtResult FlirtParser::parse(const QByteArray &data) {
     FlirtResult result;
+    m_published = 0;
+    m_nextBatch = qMin(FIRST_MODULE_BATCH, m_maxBatch);
     ParseState st;
     st.body = data;
     st.pos = 0;
@@ -423,6 +464,7 @@ FlirtResult FlirtParser::parse(const QByteArray &data) {
             return result;
         }
         st.body = decompressed;
+        result.bodyDecompressed = true;
         st.pos = 0;
         st.eof = false;
         st.err = false;
@@ -433,58 +475,120 @@ FlirtResult FlirtParser::parse(const QByteArray &data) {
     }
 
     QVector<FlirtPatternNode> path;
-    if (!parseTree(st, result, path, result.modules)) {
-        if (result.errorMessage.isEmpty()) result.errorMessage = "Parse error in signature tree";
+    result.nodes.append(FlirtTreeNode());
+    if (!parseTree(st, result, 0, path, result.modules)) {
+        if (st.canceled) result.errorMessage = "Canceled";
+        else if (result.errorMessage.isEmpty()) result.errorMessage = "Parse error in signature tree";
+        return result;
+    }
+    if (!publishModules(result.modules, true)) {
+        result.errorMessage = "Canceled";
         return result;
     }
 
+    result.body = st.body;
     result.success = true;
     return result;
 }
 
+FlirtResult FlirtParser::parseHeaderOnly(const QByteArray &data) {
+    FlirtResult result;
+    ParseState st;
+    st.body = data;
+    if (!isFlirt(data, &st.version)) {
+        result.errorMessage = "Not a valid FLIRT .sig file";
+        return result;
+    }
+    result.success = parseHeader(st, result);
+    return result;
+}
+
+FlirtResult FlirtParser::parseFile(const QString &path) {
+    FlirtResult result;
+    auto f = std::make_shared<QFile>(path);
+    if (!f->open(QIODevice::ReadOnly)) {
+        result.errorMessage = "Cannot open file: " + path;
+        return result;
+    }
+    // Map the file instead of copying it; the mapping lives as long as the result's body
+    QByteArray data;
+    uchar *mapped = f->size() > 0 ? f->map(0, f->size()) : nullptr;
+    if (mapped)
+        data = QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), f->size());
+    else
+        data = f->readAll();
+    if (path.endsWith(".sig.gz", Qt::CaseInsensitive)) {
+        data = decompressGzip(data);
+        if (data.isEmpty()) {
+            result.errorMessage = "Failed to decompress .sig.gz file.";
+            return result;
+        }
+    }
+    result = parse(data);
+    if (!result.success)
+        result.errorMessage = "Parse error: " + result.errorMessage;
+    else if (mapped && !result.bodyDecompressed && !path.endsWith(".sig.gz", Qt::CaseInsensitive))
+        result.mappedFile = f;
+    else
+        result.mappedFile.reset();
+    return result;
+}
+
 // Display helpers (minimal set for common archs)
 QString archToString(quint8 arch) {
     switch (arch) {
-    case 0: return "386";
-    case 7: return "68K";
-    case 12: return "MIPS";
-    case 13: return "ARM";
-    case 15: return "PPC";
-    case 18: return "SH";
-    case 19: return "NET";
-    case 23: return "SPARC";
-    case 31: return "IA64";
+    case IDASIG_ARCH_386: return "386";
+    case IDASIG_ARCH_68K: return "68K";
+    case IDASIG_ARCH_MIPS: return "MIPS";
+    case IDASIG_ARCH_ARM: return "ARM";
+    case IDASIG_ARCH_PPC: return "PPC";
+    case IDASIG_ARCH_SH: return "SH";
+    case IDASIG_ARCH_NET: return "NET";
+    case IDASIG_ARCH_SPARC: return "SPARC";
+    case IDASIG_ARCH_IA64: return "IA64";
     case 58: return "MSP430";
-    case 60: return "DALVIK";
+    case IDASIG_ARCH_DALVIK: return "DALVIK";
     default: return QString("ARCH_%1").arg(arch);
     }
 }
 
 QString fileTypesToString(quint32 ft) {
     QStringList s;
-    if (ft & 0x04) s << "BIN";
-    if (ft & 0x400) s << "COFF";
-    if (ft & 0x800) s << "PE";
-    if (ft & 0x4000) s << "ELF";
+    if (ft & (IDASIG_FILE_DOS_EXE_OLD | IDASIG_FILE_DOS_EXE)) s << "DOS_EXE";
+    if (ft & IDASIG_FILE_DOS_COM_OLD) s << "DOS_COM";
+    if (ft & IDASIG_FILE_BIN) s << "BIN";
+    if (ft & IDASIG_FILE_NE) s << "NE";
+    if (ft & (IDASIG_FILE_LX | IDASIG_FILE_LE)) s << "LX/LE";
+    if (ft & IDASIG_FILE_COFF) s << "COFF";
+    if (ft & IDASIG_FILE_PE) s << "PE";
+    if (ft & IDASIG_FILE_ELF) s << "ELF";
+    if (ft & IDASIG_FILE_MACHO) s << "MACHO";
     if (s.isEmpty()) s << QString("0x%1").arg(ft, 8, 16);
     return s.join(",");
 }
 
 QString osTypesToString(quint16 ot) {
     QStringList s;
-    if (ot & 0x01) s << "MSDOS";
-    if (ot & 0x02) s << "WIN";
-    if (ot & 0x10) s << "UNIX";
+    if (ot & IDASIG_OS_MSDOS) s << "MSDOS";
+    if (ot & IDASIG_OS_WIN) s << "WIN";
+    if (ot & IDASIG_OS_OS2) s << "OS2";
+    if (ot & IDASIG_OS_NETWARE) s << "NETWARE";
+    if (ot & IDASIG_OS_UNIX) s << "UNIX";
+    if (ot & IDASIG_OS_OTHER) s << "OTHER";
     if (s.isEmpty()) s << QString("0x%1").arg(ot, 4, 16);
     return s.join(",");
 }
 
 QString appTypesToString(quint16 at) {
     QStringList s;
-    if (at & 0x04) s << "EXE";
-    if (at & 0x08) s << "DLL";
-    if (at & 0x100) s << "32_BIT";
-    if (at & 0x200) s << "64_BIT";
+    if (at & IDASIG_APP_CONSOLE) s << "CONSOLE";
+    if (at & IDASIG_APP_GRAPHICS) s << "GRAPHICS";
+    if (at & IDASIG_APP_EXE) s << "EXE";
+    if (at & IDASIG_APP_DLL) s << "DLL";
+    if (at & IDASIG_APP_DRV) s << "DRV";
+    if (at & IDASIG_APP_16_BIT) s << "16_BIT";
+    if (at & IDASIG_APP_32_BIT) s << "32_BIT";
+    if (at & IDASIG_APP_64_BIT) s << "64_BIT";
     if (s.isEmpty()) s << QString("0x%1").arg(at, 4, 16);
     return s.join(",");
 }
@@ -4,6 +4,10 @@
 #include <QString>
 #include <QByteArray>
 #include <QVector>
+#include <functional>
+#include <memory>
+
+class QFile;
 
 namespace SigParser {
 
@@ -18,6 +22,44 @@ constexpr uint8_t IDASIG_FUNCTION_LOCAL = 0x02;
 constexpr uint8_t IDASIG_FUNCTION_UNRESOLVED_COLLISION = 0x08;
 constexpr int FLIRT_NAME_MAX = 1024;
 
+// Header fields (IDA SDK processor ids, filetype_t bits, OSTYPE_* and APPT_* flags)
+constexpr quint8 IDASIG_ARCH_386 = 0;
+constexpr quint8 IDASIG_ARCH_68K = 7;
+constexpr quint8 IDASIG_ARCH_MIPS = 12;
+constexpr quint8 IDASIG_ARCH_ARM = 13;
+constexpr quint8 IDASIG_ARCH_PPC = 15;
+constexpr quint8 IDASIG_ARCH_SH = 18;
+constexpr quint8 IDASIG_ARCH_NET = 19;
+constexpr quint8 IDASIG_ARCH_SPARC = 23;
+constexpr quint8 IDASIG_ARCH_IA64 = 31;
+constexpr quint8 IDASIG_ARCH_DALVIK = 60;
+constexpr quint32 IDASIG_FILE_DOS_EXE_OLD = 0x00000001;
+constexpr quint32 IDASIG_FILE_DOS_COM_OLD = 0x00000002;
+constexpr quint32 IDASIG_FILE_BIN = 0x00000004;
+constexpr quint32 IDASIG_FILE_NE = 0x00000010;
+constexpr quint32 IDASIG_FILE_LX = 0x00000080;
+constexpr quint32 IDASIG_FILE_LE = 0x00000100;
+constexpr quint32 IDASIG_FILE_COFF = 0x00000400;
+constexpr quint32 IDASIG_FILE_PE = 0x00000800;
+constexpr quint32 IDASIG_FILE_ZIP = 0x00004000;
+constexpr quint32 IDASIG_FILE_ELF = 0x00040000;
+constexpr quint32 IDASIG_FILE_DOS_EXE = 0x00400000;
+constexpr quint32 IDASIG_FILE_MACHO = 0x02000000;
+constexpr quint16 IDASIG_OS_MSDOS = 0x01;
+constexpr quint16 IDASIG_OS_WIN = 0x02;
+constexpr quint16 IDASIG_OS_OS2 = 0x04;
+constexpr quint16 IDASIG_OS_NETWARE = 0x08;
+constexpr quint16 IDASIG_OS_UNIX = 0x10;
+constexpr quint16 IDASIG_OS_OTHER = 0x20;
+constexpr quint16 IDASIG_APP_CONSOLE = 0x0001;
+constexpr quint16 IDASIG_APP_GRAPHICS = 0x0002;
+constexpr quint16 IDASIG_APP_EXE = 0x0004;
+constexpr quint16 IDASIG_APP_DLL = 0x0008;
+constexpr quint16 IDASIG_APP_DRV = 0x0010;
+constexpr quint16 IDASIG_APP_16_BIT = 0x0080;
+constexpr quint16 IDASIG_APP_32_BIT = 0x0100;
+constexpr quint16 IDASIG_APP_64_BIT = 0x0200;
+
 struct FlirtFunction {
     QString name;
     quint32 offset = 0;
@@ -43,14 +85,36 @@ struct FlirtPatternNode {
     QString toHexString() const;
 };
 
+// One node of the signature trie; nodes are stored in file (pre-order) order
+struct FlirtTreeNode {
+    int parent = -1;        // -1 for the root
+    int depth = 0;          // root = 0
+    FlirtPatternNode pattern;
+    QVector<int> children;
+    qsizetype bodyBegin = -1;  // bytes of FlirtResult::body holding this node's length, mask and pattern
+    qsizetype bodyEnd = -1;
+    // Modules and allFunctions() ordinals under this node; subtrees are contiguous in DFS order
+    int moduleBegin = 0;
+    int moduleEnd = 0;
+    int functionBegin = 0;
+    int functionEnd = 0;
+    int moduleCount() const { return moduleEnd - moduleBegin; }
+    int functionCount() const { return functionEnd - functionBegin; }
+};
+
 struct FlirtModule {
     QVector<FlirtPatternNode> patternPath;  // path from root to this leaf
+    int patternLength = 0;                  // bytes along patternPath; kept when the path is dropped
+    int patternFixedBytes = 0;              // non-variant bytes along patternPath
+    int leafNode = -1;                      // index into FlirtResult::nodes
     quint32 crcLength = 0;
     quint32 crc16 = 0;
     quint32 length = 0;
     QVector<FlirtFunction> publicFunctions;
     QVector<FlirtTailByte> tailBytes;
     QVector<FlirtRefFunction> referencedFunctions;
+    qsizetype bodyBegin = -1;  // bytes of FlirtResult::body consumed for this module record
+    qsizetype bodyEnd = -1;
     QString patternPathHex() const;
     QString rulesSummary() const;
 };
@@ -78,6 +142,12 @@ struct FlirtResult {
     QString libraryName;
     FlirtHeader header;
     QVector<FlirtModule> modules;
+    QVector<FlirtTreeNode> nodes;  // nodes[0] is the root (empty pattern)
+    // Bytes the trie was parsed from: the file itself, or the inflated body of a compressed
+    // signature. May wrap a read-only mapping of the file, kept alive by mappedFile.
+    QByteArray body;
+    bool bodyDecompressed = false;
+    std::shared_ptr<QFile> mappedFile;
     // Flattened list of all public functions with module index for display
     struct FunctionEntry {
         int moduleIndex = 0;
@@ -92,23 +162,37 @@ struct ParseState {
     QByteArray body;
     qsizetype pos = 0;
     int version = 0;
+    int functionCount = 0;  // public functions in the modules parsed so far
     bool eof = false;
     bool err = false;
+    bool canceled = false;  // the batch callback asked to stop
 };
 
 class FlirtParser
 {
 public:
+    /**
+     * Receives completed modules in file order while parse() is still running. Returning false
+     * stops the parse, which then fails with "Canceled".
+     */
+    using ModuleBatchCallback = std::function<bool(const QVector<FlirtModule> &batch)>;
+
     FlirtParser() = default;
+    /** Publish modules in batches that grow from a small first batch up to maxBatch. */
+    void setModuleBatchCallback(ModuleBatchCallback callback, int maxBatch = 8192);
     FlirtResult parse(const QByteArray &data);
+    /** Parse only the header and library name; success is set when they are complete. */
+    static FlirtResult parseHeaderOnly(const QByteArray &data);
+    /** Read and parse a .sig or .sig.gz file; errors are reported through FlirtResult::errorMessage. */
+    FlirtResult parseFile(const QString &path);
     static bool isFlirt(const QByteArray &data, int *outVersion = nullptr);
     /** Decompress gzip (.sig.gz) file content. Returns empty QByteArray on error. */
     static QByteArray decompressGzip(const QByteArray &gzipData);
 
 private:
-    bool parseHeader(ParseState &st, FlirtResult &result);
-    bool parseTree(ParseState &st, FlirtResult &result, QVector<FlirtPatternNode> &path, QVector<FlirtModule> &modulesOut);
-    bool parseLeaf(ParseState &st, const QVector<FlirtPatternNode> &path, QVector<FlirtModule> &modulesOut);
+    static bool parseHeader(ParseState &st, FlirtResult &result);
+    bool parseTree(ParseState &st, FlirtResult &result, int nodeIndex, QVector<FlirtPatternNode> &path, QVector<FlirtModule> &modulesOut);
+    bool parseLeaf(ParseState &st, int nodeIndex, const QVector<FlirtPatternNode> &path, QVector<FlirtModule> &modulesOut);
     bool readNodeLength(ParseState &st, quint8 &len);
     bool readNodeVariantMask(ParseState &st, quint8 nodeLen, quint64 &mask);
     bool readNodeBytes(ParseState &st, quint8 nodeLen, quint64 variantMask, FlirtPatternNode &nodeOut);
@@ -116,10 +200,12 @@ private:
     bool readModuleTailBytes(ParseState &st, FlirtModule &mod);
     bool readModuleReferencedFunctions(ParseState &st, FlirtModule &mod);
 
-    quint8 readByte(ParseState &st);
-    quint16 readShortBE(ParseState &st);
-    quint16 readMax2Bytes(ParseState &st);
-    quint32 readMultipleBytes(ParseState &st);
+    bool publishModules(const QVector<FlirtModule> &modules, bool flush);
+
+    ModuleBatchCallback m_batchCallback;
+    int m_maxBatch = 8192;
+    int m_nextBatch = 0;
+    qsizetype m_published = 0;
 };
 
 // Display helpers
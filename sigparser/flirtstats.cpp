@@ -0,0 +1,157 @@
+#include "flirtstats.h"
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+#include <climits>
+
+namespace SigParser {
+
+// Work unit for the parallel pass: a slice of modules and a slice of nodes
+struct StatsChunk {
+    int moduleBegin = 0;
+    int moduleEnd = 0;
+    int nodeBegin = 0;
+    int nodeEnd = 0;
+};
+
+static constexpr int STATS_CHUNK_SIZE = 4096;
+
+Histogram::Histogram(Scale s, int bucketCount, quint32 width)
+    : scale(s), bucketWidth(width ? width : 1), buckets(bucketCount, 0) {
+}
+
+int Histogram::bucketFor(quint64 value) const {
+    int b;
+    if (scale == Scale::Log2) {
+        b = 0;
+        while (value) {
+            ++b;
+            value >>= 1;
+        }
+    } else {
+        b = static_cast<int>(std::min<quint64>(value / bucketWidth, INT_MAX));
+    }
+    return std::min(b, static_cast<int>(buckets.size()) - 1);
+}
+
+void Histogram::add(quint64 value) {
+    if (buckets.isEmpty()) return;
+    ++buckets[bucketFor(value)];
+    if (count == 0 || value < minValue) minValue = value;
+    if (count == 0 || value > maxValue) maxValue = value;
+    ++count;
+    sum += value;
+}
+
+void Histogram::merge(const Histogram &other) {
+    if (other.count == 0) return;
+    if (buckets.size() < other.buckets.size()) buckets.resize(other.buckets.size());
+    for (int i = 0; i < other.buckets.size(); ++i)
+        buckets[i] += other.buckets[i];
+    if (count == 0 || other.minValue < minValue) minValue = other.minValue;
+    if (count == 0 || other.maxValue > maxValue) maxValue = other.maxValue;
+    count += other.count;
+    sum += other.sum;
+}
+
+double Histogram::mean() const {
+    return count ? static_cast<double>(sum) / count : 0.0;
+}
+
+QString Histogram::bucketLabel(int bucket) const {
+    const bool last = bucket == buckets.size() - 1;
+    if (scale == Scale::Log2) {
+        if (bucket == 0) return "0";
+        const quint64 lo = 1ULL << (bucket - 1);
+        const quint64 hi = (1ULL << bucket) - 1;
+        if (last) return QString(">=%1").arg(lo);
+        return lo == hi ? QString::number(lo) : QString("%1-%2").arg(lo).arg(hi);
+    }
+    const quint64 lo = static_cast<quint64>(bucket) * bucketWidth;
+    if (last) return QString(">=%1").arg(lo);
+    if (bucketWidth == 1) return QString::number(lo);
+    return QString("%1-%2").arg(lo).arg(lo + bucketWidth - 1);
+}
+
+FlirtStatistics::FlirtStatistics() {
+    histograms[ModuleLength] = Histogram(Histogram::Scale::Log2, 33);
+    histograms[CrcLength] = Histogram(Histogram::Scale::Linear, 33, 8);
+    histograms[TrieDepth] = Histogram(Histogram::Scale::Linear, 33);
+    histograms[NodeLength] = Histogram(Histogram::Scale::Linear, 65);
+    histograms[VariantRatio] = Histogram(Histogram::Scale::Linear, 11, 10);
+    histograms[TailByteCount] = Histogram(Histogram::Scale::Linear, 17);
+    histograms[ReferenceCount] = Histogram(Histogram::Scale::Linear, 17);
+    histograms[NameLength] = Histogram(Histogram::Scale::Log2, 12);
+}
+
+void FlirtStatistics::merge(const FlirtStatistics &other) {
+    for (int i = 0; i < MetricCount; ++i)
+        histograms[i].merge(other.histograms[i]);
+    moduleCount += other.moduleCount;
+    functionCount += other.functionCount;
+    nodeCount += other.nodeCount;
+}
+
+QString FlirtStatistics::metricName(Metric m) {
+    switch (m) {
+    case ModuleLength: return "Module length";
+    case CrcLength: return "CRC length";
+    case TrieDepth: return "Trie depth";
+    case NodeLength: return "Node length";
+    case VariantRatio: return "Variant bytes (%)";
+    case TailByteCount: return "Tail bytes";
+    case ReferenceCount: return "Referenced functions";
+    case NameLength: return "Name length";
+    default: return QString();
+    }
+}
+
+static FlirtStatistics statisticsForChunk(const FlirtResult &result, const StatsChunk &chunk) {
+    FlirtStatistics s;
+    for (int mi = chunk.moduleBegin; mi < chunk.moduleEnd; ++mi) {
+        const FlirtModule &mod = result.modules[mi];
+        s.histograms[FlirtStatistics::ModuleLength].add(mod.length);
+        s.histograms[FlirtStatistics::CrcLength].add(mod.crcLength);
+        s.histograms[FlirtStatistics::TrieDepth].add(mod.patternPath.size());
+        s.histograms[FlirtStatistics::TailByteCount].add(mod.tailBytes.size());
+        s.histograms[FlirtStatistics::ReferenceCount].add(mod.referencedFunctions.size());
+        qsizetype total = 0;
+        qsizetype variant = 0;
+        for (const FlirtPatternNode &n : mod.patternPath) {
+            total += n.variantMask.size();
+            variant += n.variantMask.count(char(1));
+        }
+        s.histograms[FlirtStatistics::VariantRatio].add(total ? static_cast<quint64>(variant * 100 / total) : 0);
+        for (const FlirtFunction &f : mod.publicFunctions)
+            s.histograms[FlirtStatistics::NameLength].add(f.name.size());
+        s.functionCount += mod.publicFunctions.size();
+        ++s.moduleCount;
+    }
+    for (int ni = chunk.nodeBegin; ni < chunk.nodeEnd; ++ni) {
+        if (result.nodes[ni].parent < 0) continue;  // root carries no pattern
+        s.histograms[FlirtStatistics::NodeLength].add(result.nodes[ni].pattern.patternBytes.size());
+        ++s.nodeCount;
+    }
+    return s;
+}
+
+FlirtStatistics computeStatistics(const FlirtResult &result) {
+    const int modules = result.modules.size();
+    const int nodes = result.nodes.size();
+    const int chunkCount = (std::max(modules, nodes) + STATS_CHUNK_SIZE - 1) / STATS_CHUNK_SIZE;
+    QVector<StatsChunk> chunks;
+    chunks.reserve(chunkCount);
+    for (int i = 0; i < chunkCount; ++i) {
+        StatsChunk c;
+        c.moduleBegin = std::min(i * STATS_CHUNK_SIZE, modules);
+        c.moduleEnd = std::min(c.moduleBegin + STATS_CHUNK_SIZE, modules);
+        c.nodeBegin = std::min(i * STATS_CHUNK_SIZE, nodes);
+        c.nodeEnd = std::min(c.nodeBegin + STATS_CHUNK_SIZE, nodes);
+        chunks.append(c);
+    }
+    return QtConcurrent::blockingMappedReduced<FlirtStatistics>(
+        chunks,
+        [&result](const StatsChunk &c) { return statisticsForChunk(result, c); },
+        [](FlirtStatistics &acc, const FlirtStatistics &part) { acc.merge(part); });
+}
+
+} // namespace SigParser
@@ -0,0 +1,59 @@
+#ifndef FLIRTSTATS_H
+#define FLIRTSTATS_H
+
+#include "flirtparser.h"
+#include <array>
+
+namespace SigParser {
+
+// Bucketed value distribution. Linear histograms put value/width into a bucket and
+// clamp into the last one; Log2 histograms use bucket 0 for 0 and k for [2^(k-1), 2^k).
+struct Histogram {
+    enum class Scale { Linear, Log2 };
+
+    Scale scale = Scale::Linear;
+    quint32 bucketWidth = 1;
+    QVector<quint64> buckets;
+    quint64 count = 0;
+    quint64 sum = 0;
+    quint64 minValue = 0;
+    quint64 maxValue = 0;
+
+    Histogram() = default;
+    Histogram(Scale s, int bucketCount, quint32 width = 1);
+    int bucketFor(quint64 value) const;
+    void add(quint64 value);
+    void merge(const Histogram &other);
+    double mean() const;
+    QString bucketLabel(int bucket) const;
+};
+
+struct FlirtStatistics {
+    enum Metric {
+        ModuleLength,
+        CrcLength,
+        TrieDepth,
+        NodeLength,
+        VariantRatio,   // percent of variant bytes in the module pattern
+        TailByteCount,
+        ReferenceCount,
+        NameLength,
+        MetricCount
+    };
+
+    FlirtStatistics();
+    void merge(const FlirtStatistics &other);
+    static QString metricName(Metric m);
+
+    std::array<Histogram, MetricCount> histograms;
+    quint64 moduleCount = 0;
+    quint64 functionCount = 0;
+    quint64 nodeCount = 0;
+};
+
+/** Compute all statistics in one parallel pass over modules and trie nodes. Safe to call off the GUI thread. */
+FlirtStatistics computeStatistics(const FlirtResult &result);
+
+} // namespace SigParser
+
+#endif // FLIRTSTATS_H
@@ -0,0 +1,222 @@
+#include "frontcodeddict.h"
+#include <algorithm>
+#include <cstring>
+
+namespace SigParser {
+
+static constexpr char DICT_MAGIC[4] = { 'F', 'C', 'D', '1' };
+
+static void appendVarint(QByteArray &out, quint32 v) {
+    while (v >= 0x80) {
+        out += static_cast<char>((v & 0x7f) | 0x80);
+        v >>= 7;
+    }
+    out += static_cast<char>(v);
+}
+
+// Returns false when the varint runs past end
+static bool readVarint(const char *&p, const char *end, quint32 &v) {
+    v = 0;
+    for (int shift = 0; shift < 35 && p < end; shift += 7) {
+        const quint8 b = static_cast<quint8>(*p++);
+        v |= static_cast<quint32>(b & 0x7f) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+static int compareBytes(const QByteArray &a, const QByteArray &b) {
+    const qsizetype n = std::min(a.size(), b.size());
+    const int c = n ? std::memcmp(a.constData(), b.constData(), static_cast<size_t>(n)) : 0;
+    if (c != 0) return c;
+    return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+}
+
+FrontCodedDictionary FrontCodedDictionary::build(const QVector<QByteArray> &strings) {
+    FrontCodedDictionary d;
+    d.m_count = strings.size();
+    d.m_blockOffsets.reserve((strings.size() + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    QByteArray prev;
+    for (int i = 0; i < strings.size(); ++i) {
+        const QByteArray &s = strings[i];
+        if (i % BLOCK_SIZE == 0) {
+            d.m_blockOffsets.append(static_cast<quint32>(d.m_data.size()));
+            appendVarint(d.m_data, static_cast<quint32>(s.size()));
+            d.m_data += s;
+        } else {
+            qsizetype lcp = 0;
+            const qsizetype n = std::min(prev.size(), s.size());
+            while (lcp < n && prev[lcp] == s[lcp]) ++lcp;
+            appendVarint(d.m_data, static_cast<quint32>(lcp));
+            appendVarint(d.m_data, static_cast<quint32>(s.size() - lcp));
+            d.m_data.append(s.constData() + lcp, s.size() - lcp);
+        }
+        prev = s;
+    }
+    d.m_data.squeeze();
+    return d;
+}
+
+FrontCodedDictionary FrontCodedDictionary::fromUnsorted(QVector<QByteArray> strings) {
+    std::sort(strings.begin(), strings.end(), [](const QByteArray &a, const QByteArray &b) { return compareBytes(a, b) < 0; });
+    strings.erase(std::unique(strings.begin(), strings.end()), strings.end());
+    return build(strings);
+}
+
+QByteArray FrontCodedDictionary::blockHead(int block) const {
+    const char *p = m_data.constData() + m_blockOffsets[block];
+    quint32 len = 0;
+    readVarint(p, m_data.constData() + m_data.size(), len);
+    return QByteArray(p, len);
+}
+
+QByteArray FrontCodedDictionary::at(int id) const {
+    if (id < 0 || id >= m_count) return QByteArray();
+    const int block = id / BLOCK_SIZE;
+    const char *end = m_data.constData() + m_data.size();
+    const char *p = m_data.constData() + m_blockOffsets[block];
+    quint32 len = 0;
+    readVarint(p, end, len);
+    QByteArray s(p, len);
+    p += len;
+    for (int i = block * BLOCK_SIZE + 1; i <= id; ++i) {
+        quint32 lcp = 0;
+        quint32 suffix = 0;
+        readVarint(p, end, lcp);
+        readVarint(p, end, suffix);
+        s.truncate(lcp);
+        s.append(p, suffix);
+        p += suffix;
+    }
+    return s;
+}
+
+QVector<QByteArray> FrontCodedDictionary::range(int first, int last) const {
+    QVector<QByteArray> out;
+    first = std::max(first, 0);
+    last = std::min(last, m_count);
+    if (first >= last) return out;
+    out.reserve(last - first);
+    const char *end = m_data.constData() + m_data.size();
+    const char *p = m_data.constData() + m_blockOffsets[first / BLOCK_SIZE];
+    QByteArray s;
+    for (int id = first - first % BLOCK_SIZE; id < last; ++id) {
+        if (id % BLOCK_SIZE == 0) {
+            quint32 len = 0;
+            readVarint(p, end, len);
+            s = QByteArray(p, len);
+            p += len;
+        } else {
+            quint32 lcp = 0;
+            quint32 suffix = 0;
+            readVarint(p, end, lcp);
+            readVarint(p, end, suffix);
+            s.truncate(lcp);
+            s.append(p, suffix);
+            p += suffix;
+        }
+        if (id >= first) out.append(s);
+    }
+    return out;
+}
+
+int FrontCodedDictionary::bound(const QByteArray &key, bool upper) const {
+    if (m_count == 0) return 0;
+    // Last block whose head sorts before key (lower) or not after it (upper)
+    int lo = 0;
+    int hi = m_blockOffsets.size() - 1;
+    while (lo < hi) {
+        const int mid = (lo + hi + 1) / 2;
+        const int c = compareBytes(blockHead(mid), key);
+        if (upper ? c <= 0 : c < 0) lo = mid;
+        else hi = mid - 1;
+    }
+    const char *end = m_data.constData() + m_data.size();
+    const char *p = m_data.constData() + m_blockOffsets[lo];
+    const int last = std::min(m_count, (lo + 1) * BLOCK_SIZE);
+    QByteArray s;
+    for (int id = lo * BLOCK_SIZE; id < last; ++id) {
+        if (id == lo * BLOCK_SIZE) {
+            quint32 len = 0;
+            readVarint(p, end, len);
+            s = QByteArray(p, len);
+            p += len;
+        } else {
+            quint32 lcp = 0;
+            quint32 suffix = 0;
+            readVarint(p, end, lcp);
+            readVarint(p, end, suffix);
+            s.truncate(lcp);
+            s.append(p, suffix);
+            p += suffix;
+        }
+        const int c = compareBytes(s, key);
+        if (upper ? c > 0 : c >= 0) return id;
+    }
+    return last;
+}
+
+int FrontCodedDictionary::find(const QByteArray &key) const {
+    const int id = bound(key, false);
+    return id < m_count && at(id) == key ? id : -1;
+}
+
+QPair<int, int> FrontCodedDictionary::prefixRange(const QByteArray &prefix) const {
+    const int first = bound(prefix, false);
+    if (prefix.isEmpty()) return qMakePair(0, m_count);
+    // Smallest string greater than every string with this prefix: strip trailing 0xff, bump the last byte
+    QByteArray next = prefix;
+    while (!next.isEmpty() && static_cast<quint8>(next.back()) == 0xff)
+        next.chop(1);
+    if (next.isEmpty()) return qMakePair(first, m_count);
+    next.back() = static_cast<char>(static_cast<quint8>(next.back()) + 1);
+    return qMakePair(first, bound(next, false));
+}
+
+QByteArray FrontCodedDictionary::toBytes() const {
+    QByteArray out(DICT_MAGIC, sizeof(DICT_MAGIC));
+    appendVarint(out, static_cast<quint32>(m_count));
+    appendVarint(out, static_cast<quint32>(m_data.size()));
+    out += m_data;
+    return out;
+}
+
+bool FrontCodedDictionary::fromBytes(const QByteArray &bytes, FrontCodedDictionary &out) {
+    out = FrontCodedDictionary();
+    if (bytes.size() < qsizetype(sizeof(DICT_MAGIC)) || std::memcmp(bytes.constData(), DICT_MAGIC, sizeof(DICT_MAGIC)) != 0)
+        return false;
+    const char *p = bytes.constData() + sizeof(DICT_MAGIC);
+    const char *end = bytes.constData() + bytes.size();
+    quint32 count = 0;
+    quint32 dataSize = 0;
+    if (!readVarint(p, end, count) || !readVarint(p, end, dataSize)) return false;
+    if (static_cast<qsizetype>(dataSize) != end - p || count > dataSize + 1) return false;
+    FrontCodedDictionary d;
+    d.m_data = QByteArray(p, dataSize);
+    d.m_count = static_cast<int>(count);
+    // Rebuild the block index, validating every entry on the way
+    const char *q = d.m_data.constData();
+    const char *qend = q + d.m_data.size();
+    quint32 prevLen = 0;
+    for (quint32 i = 0; i < count; ++i) {
+        quint32 len = 0;
+        if (i % BLOCK_SIZE == 0) {
+            d.m_blockOffsets.append(static_cast<quint32>(q - d.m_data.constData()));
+            if (!readVarint(q, qend, len) || len > static_cast<quint32>(qend - q)) return false;
+            q += len;
+        } else {
+            quint32 lcp = 0;
+            quint32 suffix = 0;
+            if (!readVarint(q, qend, lcp) || !readVarint(q, qend, suffix)) return false;
+            if (lcp > prevLen || suffix > static_cast<quint32>(qend - q)) return false;
+            q += suffix;
+            len = lcp + suffix;
+        }
+        prevLen = len;
+    }
+    if (q != qend) return false;
+    out = d;
+    return true;
+}
+
+} // namespace SigParser
@@ -0,0 +1,54 @@
+#ifndef FRONTCODEDDICT_H
+#define FRONTCODEDDICT_H
+
+#include <QByteArray>
+#include <QPair>
+#include <QVector>
+
+namespace SigParser {
+
+/**
+ * Sorted, duplicate-free string dictionary with front coding. Strings are grouped into blocks
+ * of BLOCK_SIZE; the first string of a block is stored whole and each following one as
+ * (length of prefix shared with the previous string, suffix). Ids are positions in sorted
+ * (byte-wise) order. Lookup by string binary-searches block heads and then scans one block;
+ * access by id decodes at most BLOCK_SIZE - 1 entries.
+ */
+class FrontCodedDictionary
+{
+public:
+    static constexpr int BLOCK_SIZE = 16;
+
+    /** strings must be sorted byte-wise and unique. */
+    static FrontCodedDictionary build(const QVector<QByteArray> &strings);
+    /** Sort and deduplicate strings, then build. */
+    static FrontCodedDictionary fromUnsorted(QVector<QByteArray> strings);
+
+    int size() const { return m_count; }
+    QByteArray at(int id) const;
+    /** Strings with ids [first, last), decoded in one pass over their blocks. */
+    QVector<QByteArray> range(int first, int last) const;
+    /** Id of key, or -1. */
+    int find(const QByteArray &key) const;
+    /** Ids [first, second) of all strings starting with prefix. */
+    QPair<int, int> prefixRange(const QByteArray &prefix) const;
+
+    /** Flat form for on-disk caches; fromBytes() rejects truncated or inconsistent input. */
+    QByteArray toBytes() const;
+    static bool fromBytes(const QByteArray &bytes, FrontCodedDictionary &out);
+
+    qsizetype memoryBytes() const { return m_data.size() + m_blockOffsets.size() * qsizetype(sizeof(quint32)); }
+
+private:
+    QByteArray blockHead(int block) const;
+    /** First id whose string is >= key (or > key when upper is set). */
+    int bound(const QByteArray &key, bool upper) const;
+
+    QByteArray m_data;              // concatenated blocks
+    QVector<quint32> m_blockOffsets; // m_data offset per block
+    int m_count = 0;
+};
+
+} // namespace SigParser
+
+#endif // FRONTCODEDDICT_H
@@ -0,0 +1,127 @@
+#include "functionexport.h"
+#include <QIODevice>
+
+namespace SigParser {
+
+static constexpr int EXPORT_CHUNK_BYTES = 1 << 20;
+static constexpr int EXPORT_PROGRESS_ROWS = 4096;
+
+ExportFormat exportFormatForPath(const QString &path) {
+    if (path.endsWith(".tsv", Qt::CaseInsensitive) || path.endsWith(".txt", Qt::CaseInsensitive))
+        return ExportFormat::Tsv;
+    if (path.endsWith(".ndjson", Qt::CaseInsensitive) || path.endsWith(".jsonl", Qt::CaseInsensitive))
+        return ExportFormat::Ndjson;
+    return ExportFormat::Csv;
+}
+
+static void appendCsvField(QByteArray &out, const QByteArray &field) {
+    if (!field.contains(',') && !field.contains('"') && !field.contains('\n')) {
+        out += field;
+        return;
+    }
+    out += '"';
+    for (char c : field) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    out += '"';
+}
+
+static void appendTsvField(QByteArray &out, const QByteArray &field) {
+    for (char c : field)
+        out += (c == '\t' || c == '\n') ? ' ' : c;
+}
+
+void appendJsonString(QByteArray &out, const QByteArray &utf8) {
+    static const char hex[] = "0123456789abcdef";
+    out += '"';
+    for (char c : utf8) {
+        const quint8 u = static_cast<quint8>(c);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (u < 0x20) {
+            out += "\\u00";
+            out += hex[u >> 4];
+            out += hex[u & 0xf];
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+FunctionExportWriter::FunctionExportWriter(QIODevice *out, ExportFormat format)
+    : m_out(out), m_format(format) {
+    m_chunk.reserve(EXPORT_CHUNK_BYTES + 4096);
+}
+
+FunctionExportWriter::~FunctionExportWriter() {
+    flush();
+}
+
+void FunctionExportWriter::writeHeader() {
+    switch (m_format) {
+    case ExportFormat::Csv: m_chunk += "module,name,offset,local,collision,signature\n"; break;
+    case ExportFormat::Tsv: m_chunk += "module\tname\toffset\tlocal\tcollision\tsignature\n"; break;
+    case ExportFormat::Ndjson: break;
+    }
+}
+
+void FunctionExportWriter::writeRow(const FlirtResult::FunctionEntry &e) {
+    const QByteArray module = QByteArray::number(e.moduleIndex);
+    const QByteArray name = e.function->name.toUtf8();
+    const QByteArray offset = "0x" + QByteArray::number(e.function->offset, 16);
+    const QByteArray signature = e.module->patternPathHex().toLatin1();
+    switch (m_format) {
+    case ExportFormat::Csv:
+        m_chunk += module + ',';
+        appendCsvField(m_chunk, name);
+        m_chunk += ',' + offset + ',' + (e.function->isLocal ? "Y" : "") + ','
+                 + (e.function->isCollision ? "!" : "") + ',' + signature + '\n';
+        break;
+    case ExportFormat::Tsv:
+        m_chunk += module + '\t';
+        appendTsvField(m_chunk, name);
+        m_chunk += '\t' + offset + '\t' + (e.function->isLocal ? "Y" : "") + '\t'
+                 + (e.function->isCollision ? "!" : "") + '\t' + signature + '\n';
+        break;
+    case ExportFormat::Ndjson:
+        m_chunk += "{\"module\":" + module + ",\"name\":";
+        appendJsonString(m_chunk, name);
+        m_chunk += ",\"offset\":" + QByteArray::number(e.function->offset)
+                 + ",\"local\":" + (e.function->isLocal ? "true" : "false")
+                 + ",\"collision\":" + (e.function->isCollision ? "true" : "false")
+                 + ",\"signature\":\"" + signature + "\"}\n";
+        break;
+    }
+    if (m_chunk.size() >= EXPORT_CHUNK_BYTES)
+        flush();
+}
+
+bool FunctionExportWriter::flush() {
+    if (!m_chunk.isEmpty()) {
+        if (m_ok && m_out->write(m_chunk) != m_chunk.size())
+            m_ok = false;
+        m_chunk.clear();
+    }
+    return m_ok;
+}
+
+bool exportFunctions(const FlirtResult &result, const QVector<int> &ordinals, ExportFormat format,
+                     QIODevice *out, const std::function<bool(int rowsDone)> &progress) {
+    const QVector<FlirtResult::FunctionEntry> entries = result.allFunctions();
+    FunctionExportWriter writer(out, format);
+    writer.writeHeader();
+    for (int i = 0; i < ordinals.size(); ++i) {
+        const int ordinal = ordinals[i];
+        if (ordinal < 0 || ordinal >= entries.size()) continue;
+        writer.writeRow(entries[ordinal]);
+        if (progress && (i + 1) % EXPORT_PROGRESS_ROWS == 0 && !progress(i + 1))
+            return false;
+    }
+    if (progress) progress(ordinals.size());
+    return writer.flush();
+}
+
+} // namespace SigParser
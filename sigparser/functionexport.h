@@ -0,0 +1,48 @@
+#ifndef FUNCTIONEXPORT_H
+#define FUNCTIONEXPORT_H
+
+#include "flirtparser.h"
+#include <functional>
+
+class QIODevice;
+
+namespace SigParser {
+
+enum class ExportFormat { Csv, Tsv, Ndjson };
+
+/** Format from a file name extension (.csv, .tsv, .ndjson/.jsonl); CSV when unknown. */
+ExportFormat exportFormatForPath(const QString &path);
+
+/** Append utf8 as a JSON string literal (quoted, with control characters escaped). */
+void appendJsonString(QByteArray &out, const QByteArray &utf8);
+
+// Streams function rows to a device, buffering output into fixed-size chunks
+class FunctionExportWriter
+{
+public:
+    FunctionExportWriter(QIODevice *out, ExportFormat format);
+    ~FunctionExportWriter();
+
+    void writeHeader();
+    void writeRow(const FlirtResult::FunctionEntry &e);
+    /** Write any buffered bytes; false if the device reported an error. */
+    bool flush();
+
+private:
+    QIODevice *m_out;
+    ExportFormat m_format;
+    QByteArray m_chunk;
+    bool m_ok = true;
+};
+
+/**
+ * Export the functions with the given allFunctions() ordinals, in that order. progress is
+ * called every few thousand rows with the number of rows written and may return false to
+ * cancel. Returns false on cancel or write error.
+ */
+bool exportFunctions(const FlirtResult &result, const QVector<int> &ordinals, ExportFormat format,
+                     QIODevice *out, const std::function<bool(int rowsDone)> &progress = {});
+
+} // namespace SigParser
+
+#endif // FUNCTIONEXPORT_H
@@ -0,0 +1,125 @@
+#include "functionindex.h"
+#include "latin1search.h"
+#include <algorithm>
+
+namespace SigParser {
+
+FunctionIndex FunctionIndex::build(const FlirtResult &result) {
+    struct Item {
+        QByteArray key;  // case-folded UTF-8
+        const QString *name;
+        int ordinal;
+    };
+    FunctionIndex idx;
+    QVector<Item> items;
+    idx.m_moduleFirst.reserve(result.modules.size() + 1);
+    int ordinal = 0;
+    for (const FlirtModule &mod : result.modules) {
+        idx.m_moduleFirst.append(ordinal);
+        for (const FlirtFunction &f : mod.publicFunctions) {
+            items.append({ f.name.toCaseFolded().toUtf8(), &f.name, ordinal });
+            idx.m_offsets.append((static_cast<quint64>(f.offset) << 32) | static_cast<quint32>(ordinal));
+            ++ordinal;
+        }
+    }
+    idx.m_moduleFirst.append(ordinal);
+    idx.m_functionCount = ordinal;
+
+    // Byte order, as FrontCodedDictionary keeps its strings
+    std::sort(items.begin(), items.end(), [](const Item &a, const Item &b) {
+        return a.key != b.key ? a.key < b.key : a.ordinal < b.ordinal;
+    });
+    QVector<QByteArray> keys;
+    idx.m_functionName.resize(ordinal);
+    idx.m_nameFunctions.reserve(ordinal);
+    for (int i = 0; i < items.size(); ++i) {
+        if (i == 0 || items[i].key != items[i - 1].key) {
+            idx.m_nameStart.append(idx.m_nameFunctions.size());
+            idx.m_names.append(*items[i].name);
+            keys.append(items[i].key);
+            idx.m_arenaStart.append(idx.m_arena.size());
+            idx.m_arena += latin1Fold(*items[i].name);
+            idx.m_arena += '\0';
+        }
+        idx.m_functionName[items[i].ordinal] = idx.m_names.size() - 1;
+        idx.m_nameFunctions.append(items[i].ordinal);
+    }
+    idx.m_nameStart.append(idx.m_nameFunctions.size());
+    idx.m_arenaStart.append(idx.m_arena.size());
+    idx.m_keys = FrontCodedDictionary::build(keys);
+
+    std::sort(idx.m_offsets.begin(), idx.m_offsets.end());
+    return idx;
+}
+
+QVector<int> FunctionIndex::findName(const QString &key, bool prefix, int limit) const {
+    QVector<int> out;
+    const QByteArray folded = key.toCaseFolded().toUtf8();
+    QPair<int, int> ids;
+    if (prefix) {
+        ids = m_keys.prefixRange(folded);
+    } else {
+        const int id = m_keys.find(folded);
+        ids = id < 0 ? qMakePair(0, 0) : qMakePair(id, id + 1);
+    }
+    for (int id = ids.first; id < ids.second && out.size() < limit; ++id) {
+        for (int i = m_nameStart[id]; i < m_nameStart[id + 1] && out.size() < limit; ++i)
+            out.append(m_nameFunctions[i]);
+    }
+    return out;
+}
+
+QVector<QString> FunctionIndex::keys(int first, int last) const {
+    QVector<QString> out;
+    const QVector<QByteArray> utf8 = m_keys.range(first, last);
+    out.reserve(utf8.size());
+    for (const QByteArray &k : utf8)
+        out.append(QString::fromUtf8(k));
+    return out;
+}
+
+QVector<int> FunctionIndex::findOffset(quint32 offset, int limit) const {
+    QVector<int> out;
+    auto it = std::lower_bound(m_offsets.cbegin(), m_offsets.cend(), static_cast<quint64>(offset) << 32);
+    for (; it != m_offsets.cend() && (*it >> 32) == offset && out.size() < limit; ++it)
+        out.append(static_cast<int>(*it & 0xffffffffu));
+    return out;
+}
+
+QVector<int> FunctionIndex::findNamesContaining(const QString &text) const {
+    QVector<int> out;
+    const QByteArray needle = latin1Fold(text);
+    // Characters outside Latin-1 fold to '\0', which only separates names
+    if (needle.contains('\0')) return out;
+    const char *arena = m_arena.constData();
+    const qsizetype size = m_arena.size();
+    qsizetype pos = 0;
+    while ((pos = latin1Find(arena, size, needle, pos)) >= 0) {
+        const auto next = std::upper_bound(m_arenaStart.cbegin(), m_arenaStart.cend(), pos);
+        const int id = static_cast<int>(next - m_arenaStart.cbegin()) - 1;
+        if (id >= m_names.size()) break;
+        out.append(id);
+        pos = *next;  // continue with the next name
+    }
+    return out;
+}
+
+QVector<int> FunctionIndex::functionsOfName(int nameId) const {
+    if (nameId < 0 || nameId >= m_names.size()) return QVector<int>();
+    return m_nameFunctions.mid(m_nameStart[nameId], m_nameStart[nameId + 1] - m_nameStart[nameId]);
+}
+
+int FunctionIndex::moduleFirstFunction(int module) const {
+    if (module < 0 || module + 1 >= m_moduleFirst.size()) return -1;
+    return m_moduleFirst[module] < m_moduleFirst[module + 1] ? m_moduleFirst[module] : -1;
+}
+
+QVector<int> FunctionIndex::functionsOfModule(int module) const {
+    QVector<int> out;
+    if (module < 0 || module + 1 >= m_moduleFirst.size()) return out;
+    for (int f = m_moduleFirst[module]; f < m_moduleFirst[module + 1]; ++f)
+        out.append(f);
+    return out;
+}
+
+} // namespace SigParser
@@ -0,0 +1,54 @@
+#ifndef FUNCTIONINDEX_H
+#define FUNCTIONINDEX_H
+
+#include "flirtparser.h"
+#include "frontcodeddict.h"
+
+namespace SigParser {
+
+// Sorted lookup tables over the functions of one result. Functions are identified by their
+// ordinal in FlirtResult::allFunctions() order. Names are interned: each distinct case-folded
+// name is stored once and maps to the range of functions carrying it. Name ids follow the
+// UTF-8 byte order of the case-folded keys, which live front-coded in one dictionary.
+class FunctionIndex
+{
+public:
+    static FunctionIndex build(const FlirtResult &result);
+
+    /** Functions whose name equals key (case-insensitive), or starts with it when prefix is set. */
+    QVector<int> findName(const QString &key, bool prefix, int limit) const;
+    /** Functions at exactly this offset within their module. */
+    QVector<int> findOffset(quint32 offset, int limit) const;
+    /** First function of a module, or -1. */
+    int moduleFirstFunction(int module) const;
+    /** All function ordinals of a module, in ascending order. */
+    QVector<int> functionsOfModule(int module) const;
+
+    int functionCount() const { return m_functionCount; }
+    int nameCount() const { return m_names.size(); }
+    const QString &name(int nameId) const { return m_names[nameId]; }
+    QString key(int nameId) const { return QString::fromUtf8(m_keys.at(nameId)); }
+    /** Case-folded keys of name ids [first, last), decoded in one pass. */
+    QVector<QString> keys(int first, int last) const;
+    int nameIdOf(int function) const { return m_functionName[function]; }
+    /** Function ordinals carrying a name id, in ascending order. */
+    QVector<int> functionsOfName(int nameId) const;
+    /** Name ids whose name contains text (case-insensitive), in ascending order. */
+    QVector<int> findNamesContaining(const QString &text) const;
+
+private:
+    QVector<QString> m_names;        // interned names, sorted by case-folded key
+    FrontCodedDictionary m_keys;     // case-folded m_names as UTF-8, id = name id
+    QByteArray m_arena;              // Latin-1 folded names, each followed by '\0'
+    QVector<qsizetype> m_arenaStart; // m_arena offset per name id (size nameCount + 1)
+    QVector<int> m_nameStart;        // m_nameFunctions range per name id (size nameCount + 1)
+    QVector<int> m_nameFunctions;    // function ordinals grouped by name id
+    QVector<int> m_functionName;     // name id per function ordinal
+    QVector<quint64> m_offsets;      // (offset << 32 | ordinal), sorted
+    QVector<int> m_moduleFirst;      // first function ordinal per module (size modules + 1)
+    int m_functionCount = 0;
+};
+
+} // namespace SigParser
+
+#endif // FUNCTIONINDEX_H
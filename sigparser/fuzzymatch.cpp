@@ -0,0 +1,146 @@
+#include "fuzzymatch.h"
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+namespace SigParser {
+
+static constexpr int FUZZY_SCORE_MATCH = 16;
+static constexpr int FUZZY_GAP_START = 3;
+static constexpr int FUZZY_GAP_EXTEND = 1;
+static constexpr int FUZZY_BONUS_START = 10;      // first character of the name
+static constexpr int FUZZY_BONUS_SEPARATOR = 9;  // after '_', '@', '?', '$', '.', ...
+static constexpr int FUZZY_BONUS_CAMEL = 7;      // lower-to-upper or digit-to-letter hump
+static constexpr int FUZZY_BONUS_CONSECUTIVE = 5;
+static constexpr int FUZZY_FIRST_CHAR_MULTIPLIER = 2;
+static constexpr int FUZZY_CHUNK_SIZE = 16384;
+
+static int boundaryBonus(const QString &original, int i) {
+    if (i == 0) return FUZZY_BONUS_START;
+    if (i >= original.size()) return 0;
+    const QChar prev = original[i - 1];
+    const QChar cur = original[i];
+    if (!prev.isLetterOrNumber()) return FUZZY_BONUS_SEPARATOR;
+    if ((prev.isLower() && cur.isUpper()) || (prev.isDigit() && cur.isLetter())) return FUZZY_BONUS_CAMEL;
+    return 0;
+}
+
+int fuzzyScore(const QString &query, const QString &key, const QString &original) {
+    const int m = query.size();
+    const int n = key.size();
+    if (m == 0) return 0;
+    if (m > n) return -1;
+    const QChar *q = query.constData();
+    const QChar *k = key.constData();
+
+    // Forward pass: end of the first subsequence occurrence
+    int qi = 0;
+    int start = -1;
+    int end = -1;
+    for (int i = 0; i < n; ++i) {
+        if (k[i] != q[qi]) continue;
+        if (start < 0) start = i;
+        if (++qi == m) {
+            end = i + 1;
+            break;
+        }
+    }
+    if (end < 0) return -1;
+    // Backward pass: tighten the start of the window
+    qi = m - 1;
+    for (int i = end - 1; i >= start; --i) {
+        if (k[i] != q[qi]) continue;
+        if (qi == 0) {
+            start = i;
+            break;
+        }
+        --qi;
+    }
+
+    int score = 0;
+    bool prevMatched = false;
+    bool inGap = false;
+    qi = 0;
+    for (int i = start; i < end; ++i) {
+        if (qi < m && k[i] == q[qi]) {
+            int bonus = boundaryBonus(original, i);
+            if (prevMatched) bonus = std::max(bonus, FUZZY_BONUS_CONSECUTIVE);
+            if (qi == 0) bonus *= FUZZY_FIRST_CHAR_MULTIPLIER;
+            score += FUZZY_SCORE_MATCH + bonus;
+            prevMatched = true;
+            inGap = false;
+            ++qi;
+        } else {
+            score -= inGap ? FUZZY_GAP_EXTEND : FUZZY_GAP_START;
+            prevMatched = false;
+            inGap = true;
+        }
+    }
+    // Characters before the match window count as a (cheap) leading gap
+    score -= std::min(start, 8) * FUZZY_GAP_EXTEND;
+    return std::max(score, 1);
+}
+
+// Best first: higher score, then shorter name, then lower id
+static bool betterHit(const FuzzyHit &a, const FuzzyHit &b, const FunctionIndex &index) {
+    if (a.score != b.score) return a.score > b.score;
+    const int la = index.name(a.nameId).size();
+    const int lb = index.name(b.nameId).size();
+    if (la != lb) return la < lb;
+    return a.nameId < b.nameId;
+}
+
+QVector<FuzzyHit> fuzzyFindNames(const FunctionIndex &index, const QString &query, int topK) {
+    const QString folded = query.toCaseFolded();
+    const int names = index.nameCount();
+    if (folded.isEmpty() || names == 0 || topK <= 0) return QVector<FuzzyHit>();
+
+    auto better = [&index](const FuzzyHit &a, const FuzzyHit &b) { return betterHit(a, b, index); };
+    // Bounded heap with the worst kept hit on top
+    using Heap = std::priority_queue<FuzzyHit, std::vector<FuzzyHit>, decltype(better)>;
+    auto pushBounded = [topK, &better](Heap &heap, const FuzzyHit &hit) {
+        if (static_cast<int>(heap.size()) < topK) {
+            heap.push(hit);
+        } else if (better(hit, heap.top())) {
+            heap.pop();
+            heap.push(hit);
+        }
+    };
+
+    QVector<int> chunkStarts;
+    for (int i = 0; i < names; i += FUZZY_CHUNK_SIZE)
+        chunkStarts.append(i);
+    const QVector<FuzzyHit> merged = QtConcurrent::blockingMappedReduced<QVector<FuzzyHit>>(
+        chunkStarts,
+        [&](int begin) {
+            Heap heap(better);
+            const int end = std::min(begin + FUZZY_CHUNK_SIZE, names);
+            const QVector<QString> keys = index.keys(begin, end);
+            for (int id = begin; id < end; ++id) {
+                const int s = fuzzyScore(folded, keys[id - begin], index.name(id));
+                if (s > 0) pushBounded(heap, FuzzyHit{ id, s });
+            }
+            QVector<FuzzyHit> out;
+            out.reserve(static_cast<int>(heap.size()));
+            while (!heap.empty()) {
+                out.append(heap.top());
+                heap.pop();
+            }
+            return out;
+        },
+        [&](QVector<FuzzyHit> &acc, const QVector<FuzzyHit> &part) {
+            acc += part;
+            if (acc.size() > 2 * topK) {
+                std::partial_sort(acc.begin(), acc.begin() + topK, acc.end(), better);
+                acc.resize(topK);
+            }
+        });
+
+    QVector<FuzzyHit> hits = merged;
+    std::sort(hits.begin(), hits.end(), better);
+    if (hits.size() > topK) hits.resize(topK);
+    return hits;
+}
+
+} // namespace SigParser
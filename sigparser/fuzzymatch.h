@@ -0,0 +1,26 @@
+#ifndef FUZZYMATCH_H
+#define FUZZYMATCH_H
+
+#include "functionindex.h"
+
+namespace SigParser {
+
+struct FuzzyHit {
+    int nameId = -1;
+    int score = 0;
+};
+
+/**
+ * Score query as a subsequence of a name: matched characters score, starts of words
+ * (after '_', '@', '?', digits-to-letters, camelCase humps) and runs of consecutive matches
+ * earn bonuses, gaps cost. Returns -1 when query is not a subsequence. Both query and key
+ * must be case-folded; original supplies the case for camelCase boundaries.
+ */
+int fuzzyScore(const QString &query, const QString &key, const QString &original);
+
+/** Best topK interned names for query, best first, scored in parallel with a bounded heap per slice. */
+QVector<FuzzyHit> fuzzyFindNames(const FunctionIndex &index, const QString &query, int topK = 200);
+
+} // namespace SigParser
+
+#endif // FUZZYMATCH_H
@@ -0,0 +1,124 @@
+#include "latin1search.h"
+#include "simd.h"
+#include <cstring>
+
+namespace SigParser {
+
+static inline char foldByte(unsigned char c) {
+    if ((c >= 'A' && c <= 'Z') || (c >= 0xc0 && c <= 0xde && c != 0xd7))
+        return static_cast<char>(c + 0x20);
+    return static_cast<char>(c);
+}
+
+QByteArray latin1Fold(const QByteArray &latin1) {
+    QByteArray out(latin1.size(), Qt::Uninitialized);
+    for (qsizetype i = 0; i < latin1.size(); ++i)
+        out[i] = foldByte(static_cast<unsigned char>(latin1[i]));
+    return out;
+}
+
+QByteArray latin1Fold(const QString &text) {
+    QByteArray out(text.size(), Qt::Uninitialized);
+    for (qsizetype i = 0; i < text.size(); ++i) {
+        const char16_t u = text[i].unicode();
+        out[i] = u < 0x100 ? foldByte(static_cast<unsigned char>(u)) : '\0';
+    }
+    return out;
+}
+
+static inline int lowestBit(unsigned mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+static qsizetype findScalar(const char *hay, qsizetype size, const char *needle, qsizetype m, qsizetype from) {
+    const char first = needle[0];
+    const char last = needle[m - 1];
+    for (qsizetype i = from; i + m <= size; ++i) {
+        if (hay[i] == first && hay[i + m - 1] == last && std::memcmp(hay + i + 1, needle + 1, m - 2) == 0)
+            return i;
+    }
+    return -1;
+}
+
+#ifdef SIGPARSER_X86
+SIGPARSER_TARGET("sse2")
+static qsizetype findSse2(const char *hay, qsizetype size, const char *needle, qsizetype m, qsizetype from) {
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[m - 1]);
+    qsizetype i = from;
+    for (; i + m - 1 + 16 <= size; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(hay + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(hay + i + m - 1));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last))));
+        while (mask) {
+            const qsizetype at = i + lowestBit(mask);
+            if (std::memcmp(hay + at + 1, needle + 1, m - 2) == 0) return at;
+            mask &= mask - 1;
+        }
+    }
+    return findScalar(hay, size, needle, m, i);
+}
+
+SIGPARSER_TARGET("avx2")
+static qsizetype findAvx2(const char *hay, qsizetype size, const char *needle, qsizetype m, qsizetype from) {
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[m - 1]);
+    qsizetype i = from;
+    for (; i + m - 1 + 32 <= size; i += 32) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(hay + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(hay + i + m - 1));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last))));
+        while (mask) {
+            const qsizetype at = i + lowestBit(mask);
+            if (std::memcmp(hay + at + 1, needle + 1, m - 2) == 0) return at;
+            mask &= mask - 1;
+        }
+    }
+    return findScalar(hay, size, needle, m, i);
+}
+#endif // SIGPARSER_X86
+
+using FindFn = qsizetype (*)(const char *, qsizetype, const char *, qsizetype, qsizetype);
+
+struct Kernel {
+    FindFn find;
+    const char *name;
+};
+
+static Kernel selectKernel() {
+#ifdef SIGPARSER_X86
+    if (cpuHasAvx2()) return { findAvx2, "avx2" };
+    return { findSse2, "sse2" };
+#else
+    return { findScalar, "scalar" };
+#endif
+}
+
+static const Kernel &kernel() {
+    static const Kernel k = selectKernel();
+    return k;
+}
+
+qsizetype latin1Find(const char *haystack, qsizetype size, const QByteArray &needle, qsizetype from) {
+    const qsizetype m = needle.size();
+    if (from < 0) from = 0;
+    if (m == 0) return from <= size ? from : -1;
+    if (m == 1) {
+        if (from >= size) return -1;
+        const void *p = std::memchr(haystack + from, needle[0], static_cast<size_t>(size - from));
+        return p ? static_cast<const char *>(p) - haystack : -1;
+    }
+    return kernel().find(haystack, size, needle.constData(), m, from);
+}
+
+const char *latin1FindKernel() {
+    return kernel().name;
+}
+
+} // namespace SigParser
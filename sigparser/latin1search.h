@@ -0,0 +1,29 @@
+#ifndef LATIN1SEARCH_H
+#define LATIN1SEARCH_H
+
+#include <QByteArray>
+#include <QString>
+
+namespace SigParser {
+
+/**
+ * Latin-1 case folding as QString applies it to FLIRT names: ASCII A-Z and U+00C0..U+00DE
+ * (except U+00D7) map to lower case. Characters outside Latin-1 become 0, which no folded
+ * name contains.
+ */
+QByteArray latin1Fold(const QString &text);
+QByteArray latin1Fold(const QByteArray &latin1);
+
+/**
+ * First index >= from where needle occurs in haystack, or -1. Both must already be folded.
+ * Candidates are found by comparing the needle's first and last byte against 16 (SSE2) or
+ * 32 (AVX2) positions at a time; the instruction set is picked once at run time.
+ */
+qsizetype latin1Find(const char *haystack, qsizetype size, const QByteArray &needle, qsizetype from = 0);
+
+/** Name of the kernel latin1Find dispatches to ("avx2", "sse2" or "scalar"). */
+const char *latin1FindKernel();
+
+} // namespace SigParser
+
+#endif // LATIN1SEARCH_H
@@ -0,0 +1,180 @@
+#include "matchcache.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QLockFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+
+namespace SigParser {
+
+static constexpr quint32 MATCH_CACHE_MAGIC = 0x464d4331;  // "FMC1"
+static constexpr int MATCH_CACHE_LOCK_TIMEOUT_MS = 10000;
+static const char MATCH_CACHE_SUFFIX[] = ".fmc";
+
+MatchCache::MatchCache(const QString &dir, qint64 maxBytes)
+    : m_dir(dir), m_maxBytes(maxBytes) {
+    QDir().mkpath(m_dir);
+}
+
+QString MatchCache::defaultDirectory() {
+    // Generic location, so the GUI and the CLI (different application names) share it
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/SigViewer/matches";
+}
+
+QByteArray MatchCache::contentHash(const QByteArray &data) {
+    return QCryptographicHash::hash(data, QCryptographicHash::Blake2b_256);
+}
+
+QByteArray MatchCache::signatureSetHash(const QVector<CorpusSignature> &signatures) {
+    QCryptographicHash h(QCryptographicHash::Blake2b_256);
+    for (const CorpusSignature &sig : signatures) {
+        const FlirtResult &r = sig.matcher->result();
+        h.addData(sig.name.toUtf8());
+        h.addData(QByteArray::number(r.header.version) + ':' + QByteArray::number(r.header.arch) + ':'
+                  + QByteArray::number(r.modules.size()) + ':' + QByteArray::number(r.body.size()) + ';');
+        h.addData(r.body);
+    }
+    return h.result();
+}
+
+QByteArray MatchCache::key(const QByteArray &binaryHash, const QByteArray &signatureSetHash, const QByteArray &options) {
+    QCryptographicHash h(QCryptographicHash::Blake2b_256);
+    h.addData(binaryHash);
+    h.addData(signatureSetHash);
+    h.addData(options);
+    return h.result();
+}
+
+QString MatchCache::entryPath(const QByteArray &key) const {
+    const QString hex = QString::fromLatin1(key.toHex());
+    return m_dir + '/' + hex.left(2) + '/' + hex.mid(2) + MATCH_CACHE_SUFFIX;
+}
+
+bool MatchCache::lookup(const QByteArray &key, CorpusFileResult &out) const {
+    QFile f(entryPath(key));
+    if (!f.open(QIODevice::ReadOnly)) return false;
+    const QByteArray bytes = qUncompress(f.readAll());
+    QDataStream ds(bytes);
+    ds.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    QString format;
+    qint64 starts = 0;
+    qint32 signaturesRun = 0;
+    QVector<qint64> offsets;
+    QVector<qint32> signatures;
+    QVector<qint32> modules;
+    ds >> magic >> format >> starts >> signaturesRun >> offsets >> signatures >> modules;
+    if (ds.status() != QDataStream::Ok || magic != MATCH_CACHE_MAGIC || offsets.size() != signatures.size()
+        || offsets.size() != modules.size())
+        return false;
+    out.format = format;
+    out.starts = starts;
+    out.signaturesRun = signaturesRun;
+    out.matches.clear();
+    out.matches.reserve(offsets.size());
+    qint64 offset = 0;
+    for (int i = 0; i < offsets.size(); ++i) {
+        offset += offsets[i];  // stored as deltas
+        out.matches.append({ offset, signatures[i], modules[i] });
+    }
+    // Recently used entries survive eviction
+    f.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    return true;
+}
+
+bool MatchCache::store(const QByteArray &key, const CorpusFileResult &result) {
+    QVector<qint64> offsets;
+    QVector<qint32> signatures;
+    QVector<qint32> modules;
+    qint64 previous = 0;
+    for (const CorpusMatch &m : result.matches) {
+        offsets.append(m.offset - previous);
+        previous = m.offset;
+        signatures.append(m.signature);
+        modules.append(m.module);
+    }
+    QByteArray bytes;
+    QDataStream ds(&bytes, QIODevice::WriteOnly);
+    ds.setVersion(QDataStream::Qt_6_0);
+    ds << MATCH_CACHE_MAGIC << result.format << result.starts << qint32(result.signaturesRun) << offsets << signatures << modules;
+    bytes = qCompress(bytes);
+
+    QMutexLocker threadLock(&m_writeMutex);
+    QLockFile lock(m_dir + "/cache.lock");
+    if (!lock.tryLock(MATCH_CACHE_LOCK_TIMEOUT_MS)) return false;
+    const QString path = entryPath(key);
+    QDir().mkpath(QFileInfo(path).path());
+    // Before the commit: without a usage file readUsage() scans the directory, which must not
+    // count the new entry already. The scan may evict, so the replaced size is taken after it.
+    qint64 usage = readUsage();
+    const qint64 replaced = QFileInfo(path).size();
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(bytes) != bytes.size() || !file.commit()) return false;
+
+    usage += bytes.size() - replaced;
+    if (usage > m_maxBytes) usage = evict(m_maxBytes / 4 * 3);
+    writeUsage(usage);
+    return true;
+}
+
+qint64 MatchCache::evict(qint64 target) const {
+    struct Entry {
+        QString path;
+        qint64 size;
+        QDateTime used;
+    };
+    QVector<Entry> entries;
+    qint64 usage = 0;
+    QDirIterator it(m_dir, QStringList() << QString("*") + MATCH_CACHE_SUFFIX, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        entries.append({ info.filePath(), info.size(), info.lastModified() });
+        usage += info.size();
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.used < b.used; });
+    for (const Entry &e : entries) {
+        if (usage <= target) break;
+        if (QFile::remove(e.path)) usage -= e.size;
+    }
+    return usage;
+}
+
+qint64 MatchCache::readUsage() const {
+    QFile f(m_dir + "/usage");
+    if (!f.open(QIODevice::ReadOnly)) return evict(m_maxBytes);  // first writer: count what is there
+    bool ok = false;
+    const qint64 usage = f.readAll().trimmed().toLongLong(&ok);
+    return ok ? usage : evict(m_maxBytes);
+}
+
+void MatchCache::writeUsage(qint64 bytes) const {
+    QSaveFile f(m_dir + "/usage");
+    if (f.open(QIODevice::WriteOnly)) {
+        f.write(QByteArray::number(bytes));
+        f.commit();
+    }
+}
+
+qint64 MatchCache::usageBytes() const {
+    QFile f(m_dir + "/usage");
+    if (!f.open(QIODevice::ReadOnly)) return 0;
+    return f.readAll().trimmed().toLongLong();
+}
+
+bool MatchCache::clear() {
+    QMutexLocker threadLock(&m_writeMutex);
+    QLockFile lock(m_dir + "/cache.lock");
+    if (!lock.tryLock(MATCH_CACHE_LOCK_TIMEOUT_MS)) return false;
+    const qint64 usage = evict(0);
+    writeUsage(usage);
+    return usage == 0;
+}
+
+} // namespace SigParser
@@ -0,0 +1,54 @@
+#ifndef MATCHCACHE_H
+#define MATCHCACHE_H
+
+#include "corpusscan.h"
+#include <QMutex>
+
+namespace SigParser {
+
+/**
+ * On-disk cache of corpus scan results keyed by (binary content hash, signature set hash,
+ * scan options). Each entry is one small file under a two-level directory, written atomically,
+ * so lookups are one open and read and need no lock. Writers hold a QLockFile in the cache
+ * directory while they store and evict, which makes the cache safe to share between processes.
+ * When the entries outgrow the size budget the least recently used ones (by modification time;
+ * hits refresh it) are removed until three quarters of the budget remain.
+ */
+class MatchCache
+{
+public:
+    static constexpr qint64 DEFAULT_MAX_BYTES = qint64(256) << 20;
+
+    explicit MatchCache(const QString &dir, qint64 maxBytes = DEFAULT_MAX_BYTES);
+
+    /** Per-user cache location shared by the GUI and the CLI. */
+    static QString defaultDirectory();
+    static QByteArray contentHash(const QByteArray &data);
+    /** Hash of the signatures' content, in order (match results refer to signatures by index). */
+    static QByteArray signatureSetHash(const QVector<CorpusSignature> &signatures);
+    static QByteArray key(const QByteArray &binaryHash, const QByteArray &signatureSetHash, const QByteArray &options);
+
+    /** Fill format, starts, signaturesRun and matches of out from the entry for key. */
+    bool lookup(const QByteArray &key, CorpusFileResult &out) const;
+    bool store(const QByteArray &key, const CorpusFileResult &result);
+    /** Bytes held by entries, as last recorded by a writer. */
+    qint64 usageBytes() const;
+    bool clear();
+
+    const QString &directory() const { return m_dir; }
+
+private:
+    QString entryPath(const QByteArray &key) const;
+    /** Remove least recently used entries until usage <= target; returns the new usage. */
+    qint64 evict(qint64 target) const;
+    qint64 readUsage() const;
+    void writeUsage(qint64 bytes) const;
+
+    QString m_dir;
+    qint64 m_maxBytes;
+    mutable QMutex m_writeMutex;  // threads of this process; QLockFile covers other processes
+};
+
+} // namespace SigParser
+
+#endif // MATCHCACHE_H
@@ -0,0 +1,51 @@
+#include "matchconfidence.h"
+#include <QtEndian>
+
+namespace SigParser {
+
+// Evidence at which a match is considered a coin toss
+static constexpr int CONFIDENCE_HALF_BITS = 64;
+
+int MatchEvidence::bits() const {
+    return 8 * (fixedBytes + tailBytes) + (crcLength > 0 ? 16 : 0) + 16 * resolvedReferences;
+}
+
+MatchEvidence matchEvidence(const FlirtModule &mod, int resolvedReferences) {
+    MatchEvidence e;
+    e.fixedBytes = mod.patternFixedBytes;
+    e.crcLength = static_cast<int>(mod.crcLength);
+    e.tailBytes = mod.tailBytes.size();
+    e.references = mod.referencedFunctions.size();
+    e.resolvedReferences = resolvedReferences;
+    for (const FlirtFunction &f : mod.publicFunctions) {
+        if (f.isCollision) e.collision = true;
+    }
+    return e;
+}
+
+double matchConfidence(const MatchEvidence &evidence) {
+    const double bits = evidence.bits();
+    const double confidence = bits / (bits + CONFIDENCE_HALF_BITS);
+    return evidence.collision ? confidence / 2 : confidence;
+}
+
+int resolveX86References(const FlirtModule &mod, const QByteArray &image, qint64 offset,
+                         const QMultiHash<qint64, QString> &namesAt) {
+    int resolved = 0;
+    const uchar *data = reinterpret_cast<const uchar *>(image.constData());
+    for (const FlirtRefFunction &ref : mod.referencedFunctions) {
+        const qint64 at = offset + (ref.negativeOffset ? -qint64(ref.offset) : qint64(ref.offset));
+        if (at < 0 || at + 4 > image.size()) continue;
+        // rel32 operands are relative to the end of the operand
+        const qint64 target = at + 4 + qFromLittleEndian<qint32>(data + at);
+        for (auto it = namesAt.constFind(target); it != namesAt.cend() && it.key() == target; ++it) {
+            if (it.value() == ref.name) {
+                ++resolved;
+                break;
+            }
+        }
+    }
+    return resolved;
+}
+
+} // namespace SigParser
@@ -0,0 +1,42 @@
+#ifndef MATCHCONFIDENCE_H
+#define MATCHCONFIDENCE_H
+
+#include "flirtparser.h"
+#include <QMultiHash>
+
+namespace SigParser {
+
+// What a module match rests on
+struct MatchEvidence {
+    int fixedBytes = 0;          // non-variant pattern bytes
+    int crcLength = 0;           // bytes covered by the CRC16
+    int tailBytes = 0;
+    int references = 0;          // referenced names listed by the module
+    int resolvedReferences = 0;  // of those, found at their target in the binary
+    bool collision = false;      // a public name is flagged as an unresolved collision
+
+    /** Bits of evidence: 8 per fixed or tail byte, 16 for a CRC, 16 per resolved reference. */
+    int bits() const;
+};
+
+MatchEvidence matchEvidence(const FlirtModule &mod, int resolvedReferences = 0);
+
+/**
+ * Confidence in [0, 1) that a match is genuine: bits / (bits + 64), so 8 fixed bytes alone
+ * give 0.5 and a full 32-byte pattern with a CRC about 0.8. Collisions halve it.
+ */
+double matchConfidence(const MatchEvidence &evidence);
+inline double matchConfidence(const FlirtModule &mod, int resolvedReferences = 0) {
+    return matchConfidence(matchEvidence(mod, resolvedReferences));
+}
+
+/**
+ * Referenced names of mod (matched at offset in image) whose x86 rel32 operand points at a
+ * function known under that name; namesAt maps image offsets to the names matched there.
+ */
+int resolveX86References(const FlirtModule &mod, const QByteArray &image, qint64 offset,
+                         const QMultiHash<qint64, QString> &namesAt);
+
+} // namespace SigParser
+
+#endif // MATCHCONFIDENCE_H
@@ -0,0 +1,67 @@
+#include "matchprofile.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+
+namespace SigParser {
+
+static constexpr quint32 MATCH_PROFILE_MAGIC = 0x464d5032;  // "FMP2"
+
+static QByteArray hashBody(const FlirtResult &result) {
+    return QCryptographicHash::hash(result.body, QCryptographicHash::Blake2b_256);
+}
+
+MatchProfile MatchProfile::forResult(const FlirtResult &result) {
+    MatchProfile p;
+    p.bodyHash = hashBody(result);
+    p.nodeVisits.fill(0, result.nodes.size());
+    p.nodePasses.fill(0, result.nodes.size());
+    p.moduleHits.fill(0, result.modules.size());
+    return p;
+}
+
+bool MatchProfile::fits(const FlirtResult &result) const {
+    // Counts alone would let a profile of another signature with the same shape through
+    return nodeVisits.size() == result.nodes.size() && nodePasses.size() == result.nodes.size()
+        && moduleHits.size() == result.modules.size() && bodyHash == hashBody(result);
+}
+
+bool MatchProfile::isEmpty() const {
+    for (quint64 v : nodeVisits) {
+        if (v) return false;
+    }
+    return true;
+}
+
+void MatchProfile::merge(const MatchProfile &other) {
+    if (other.bodyHash != bodyHash || other.nodeVisits.size() != nodeVisits.size()
+        || other.nodePasses.size() != nodePasses.size() || other.moduleHits.size() != moduleHits.size()) return;
+    for (int i = 0; i < nodeVisits.size(); ++i)
+        nodeVisits[i] += other.nodeVisits[i];
+    for (int i = 0; i < nodePasses.size(); ++i)
+        nodePasses[i] += other.nodePasses[i];
+    for (int i = 0; i < moduleHits.size(); ++i)
+        moduleHits[i] += other.moduleHits[i];
+}
+
+QByteArray MatchProfile::toBytes() const {
+    QByteArray out;
+    QDataStream ds(&out, QIODevice::WriteOnly);
+    ds.setVersion(QDataStream::Qt_6_0);
+    ds << MATCH_PROFILE_MAGIC << bodyHash << nodeVisits << nodePasses << moduleHits;
+    return out;
+}
+
+bool MatchProfile::fromBytes(const QByteArray &bytes, MatchProfile &out) {
+    QDataStream ds(bytes);
+    ds.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    MatchProfile p;
+    ds >> magic;
+    if (ds.status() != QDataStream::Ok || magic != MATCH_PROFILE_MAGIC) return false;
+    ds >> p.bodyHash >> p.nodeVisits >> p.nodePasses >> p.moduleHits;
+    if (ds.status() != QDataStream::Ok || p.nodePasses.size() != p.nodeVisits.size()) return false;
+    out = p;
+    return true;
+}
+
+} // namespace SigParser
@@ -0,0 +1,31 @@
+#ifndef MATCHPROFILE_H
+#define MATCHPROFILE_H
+
+#include "flirtparser.h"
+
+namespace SigParser {
+
+// How often each trie node was visited, how often its pattern matched, and how often each
+// module fully matched while scanning. Indices follow FlirtResult::nodes and
+// FlirtResult::modules of the signature that was scanned, identified by a hash of its body.
+struct MatchProfile {
+    QByteArray bodyHash;
+    QVector<quint64> nodeVisits;
+    QVector<quint64> nodePasses;  // visits whose pattern matched; siblings differ here, not in visits
+    QVector<quint64> moduleHits;
+
+    /** Zeroed profile sized for result. */
+    static MatchProfile forResult(const FlirtResult &result);
+    /** True when the profile was recorded on result's signature body. */
+    bool fits(const FlirtResult &result) const;
+    bool isEmpty() const;
+    /** Add other's counts; both must have the same sizes. */
+    void merge(const MatchProfile &other);
+
+    QByteArray toBytes() const;
+    static bool fromBytes(const QByteArray &bytes, MatchProfile &out);
+};
+
+} // namespace SigParser
+
+#endif // MATCHPROFILE_H
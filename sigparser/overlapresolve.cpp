@@ -0,0 +1,70 @@
+#include "overlapresolve.h"
+#include "matchconfidence.h"
+#include <algorithm>
+#include <map>
+
+namespace SigParser {
+
+int matchSpecificity(const FlirtModule &mod) {
+    const MatchEvidence e = matchEvidence(mod);
+    return e.fixedBytes + e.crcLength + e.tailBytes;
+}
+
+qint64 matchLength(const FlirtModule &mod) {
+    if (mod.length > 0) return mod.length;
+    return std::max<qint64>(1, qint64(mod.patternLength) + mod.crcLength);
+}
+
+QVector<CorpusMatch> resolveOverlaps(const QVector<CorpusMatch> &matches, const QVector<CorpusSignature> &signatures,
+                                     QVector<MatchConflict> *conflicts) {
+    struct Ranked {
+        int index;
+        int specificity;
+        qint64 begin;
+        qint64 end;
+    };
+    QVector<Ranked> ranked;
+    ranked.reserve(matches.size());
+    for (int i = 0; i < matches.size(); ++i) {
+        const CorpusMatch &m = matches[i];
+        const FlirtModule &mod = signatures[m.signature].matcher->result().modules[m.module];
+        ranked.append({ i, matchSpecificity(mod), m.offset, m.offset + matchLength(mod) });
+    }
+    std::sort(ranked.begin(), ranked.end(), [&matches](const Ranked &a, const Ranked &b) {
+        if (a.specificity != b.specificity) return a.specificity > b.specificity;
+        const CorpusMatch &ma = matches[a.index];
+        const CorpusMatch &mb = matches[b.index];
+        if (ma.signature != mb.signature) return ma.signature < mb.signature;
+        if (ma.offset != mb.offset) return ma.offset < mb.offset;
+        return ma.module < mb.module;
+    });
+
+    // Kept ranges by start; they never overlap, so their ends are ordered too
+    struct Kept {
+        qint64 end;
+        int index;
+    };
+    std::map<qint64, Kept> kept;
+    for (const Ranked &r : ranked) {
+        auto next = kept.lower_bound(r.begin);
+        int blocker = -1;
+        if (next != kept.end() && next->first < r.end) blocker = next->second.index;
+        if (blocker < 0 && next != kept.begin()) {
+            const auto prev = std::prev(next);
+            if (prev->second.end > r.begin) blocker = prev->second.index;
+        }
+        if (blocker >= 0) {
+            if (conflicts) conflicts->append({ matches[r.index], matches[blocker] });
+            continue;
+        }
+        kept.emplace(r.begin, Kept{ r.end, r.index });
+    }
+
+    QVector<CorpusMatch> out;
+    out.reserve(static_cast<int>(kept.size()));
+    for (const auto &k : kept)
+        out.append(matches[k.second.index]);
+    return out;
+}
+
+} // namespace SigParser
@@ -0,0 +1,24 @@
+#ifndef OVERLAPRESOLVE_H
+#define OVERLAPRESOLVE_H
+
+#include "corpusscan.h"
+
+namespace SigParser {
+
+/** Bytes a module match pins down: fixed pattern bytes, CRC-checked bytes and tail bytes. */
+int matchSpecificity(const FlirtModule &mod);
+/** Bytes a module covers from its start: its length, or pattern plus CRC bytes when that is unset. */
+qint64 matchLength(const FlirtModule &mod);
+
+/**
+ * Non-overlapping subset of matches, sorted by offset. Matches are taken greedily by
+ * specificity (highest first), then signature priority (lower index first), then offset;
+ * each is kept unless its byte range overlaps one already kept, which an ordered map of kept
+ * ranges answers in O(log n). Dropped matches are reported with the match that beat them.
+ */
+QVector<CorpusMatch> resolveOverlaps(const QVector<CorpusMatch> &matches, const QVector<CorpusSignature> &signatures,
+                                     QVector<MatchConflict> *conflicts = nullptr);
+
+} // namespace SigParser
+
+#endif // OVERLAPRESOLVE_H
@@ -0,0 +1,108 @@
+#include "patternsearch.h"
+#include <QRegularExpression>
+#include <QStringList>
+#include <algorithm>
+
+namespace SigParser {
+
+static int hexDigit(QChar c) {
+    const ushort u = c.unicode();
+    if (u >= '0' && u <= '9') return u - '0';
+    if (u >= 'a' && u <= 'f') return u - 'a' + 10;
+    if (u >= 'A' && u <= 'F') return u - 'A' + 10;
+    return -1;
+}
+
+static bool isWildcard(QChar c) {
+    return c == '?' || c == '.';
+}
+
+bool parseBytePattern(const QString &text, BytePattern &out, QString *error) {
+    out = BytePattern();
+    const QStringList tokens = text.split(QRegularExpression("[\\s,]+"), Qt::SkipEmptyParts);
+    for (const QString &token : tokens) {
+        if (token == "?") {
+            out.bytes.append('\0');
+            out.wildcard.append('\1');
+            continue;
+        }
+        if (token.size() % 2 != 0) {
+            if (error) *error = QString("Odd number of hex digits in \"%1\"").arg(token);
+            return false;
+        }
+        for (int i = 0; i < token.size(); i += 2) {
+            if (isWildcard(token[i]) && isWildcard(token[i + 1])) {
+                out.bytes.append('\0');
+                out.wildcard.append('\1');
+                continue;
+            }
+            const int hi = hexDigit(token[i]);
+            const int lo = hexDigit(token[i + 1]);
+            if (hi < 0 || lo < 0) {
+                if (error) *error = QString("Not a hex byte: \"%1\"").arg(token.mid(i, 2));
+                return false;
+            }
+            out.bytes.append(static_cast<char>(hi << 4 | lo));
+            out.wildcard.append('\0');
+        }
+    }
+    if (out.bytes.isEmpty()) {
+        if (error) *error = "Empty byte pattern";
+        return false;
+    }
+    return true;
+}
+
+// Compare a node's pattern against query bytes starting at pos
+static bool nodeMatches(const FlirtPatternNode &node, const BytePattern &query, int pos) {
+    const int n = std::min<int>(node.patternBytes.size(), query.size() - pos);
+    const char *pattern = node.patternBytes.constData();
+    const char *variant = node.variantMask.constData();
+    const int variantSize = node.variantMask.size();
+    const char *bytes = query.bytes.constData() + pos;
+    const char *wild = query.wildcard.constData() + pos;
+    for (int i = 0; i < n; ++i) {
+        if (wild[i] || (i < variantSize && variant[i])) continue;
+        if (pattern[i] != bytes[i]) return false;
+    }
+    return true;
+}
+
+QVector<int> findModulesByPattern(const FlirtResult &result, const BytePattern &query, int limit) {
+    QVector<int> out;
+    const QVector<FlirtTreeNode> &nodes = result.nodes;
+    if (nodes.isEmpty() || query.size() == 0 || limit <= 0) return out;
+
+    auto appendModules = [&](const FlirtTreeNode &node) {
+        for (int mi = node.moduleBegin; mi < node.moduleEnd && out.size() < limit; ++mi)
+            out.append(mi);
+    };
+
+    struct Frame {
+        int node;
+        int pos;  // query bytes consumed before this node
+    };
+    QVector<Frame> stack;
+    // Children are pushed in reverse so modules come out in file order
+    auto pushChildren = [&](int node, int pos) {
+        const QVector<int> &children = nodes[node].children;
+        for (int i = children.size() - 1; i >= 0; --i)
+            stack.append({ children[i], pos });
+    };
+    // The root has an empty pattern; seeding it keeps modules that hang directly off it
+    stack.append({ 0, 0 });
+    while (!stack.isEmpty() && out.size() < limit) {
+        const Frame f = stack.takeLast();
+        const FlirtTreeNode &node = nodes[f.node];
+        if (!nodeMatches(node.pattern, query, f.pos)) continue;
+        const int pos = f.pos + node.pattern.patternBytes.size();
+        // A leaf, or the query ends within this node: the whole subtree matches
+        if (node.children.isEmpty() || pos >= query.size())
+            appendModules(node);
+        else
+            pushChildren(f.node, pos);
+    }
+    return out;
+}
+
+} // namespace SigParser
@@ -0,0 +1,31 @@
+#ifndef PATTERNSEARCH_H
+#define PATTERNSEARCH_H
+
+#include "flirtparser.h"
+
+namespace SigParser {
+
+// Byte sequence typed by the user; wildcard[i] != 0 matches any byte
+struct BytePattern {
+    QByteArray bytes;
+    QByteArray wildcard;
+    int size() const { return bytes.size(); }
+};
+
+/**
+ * Parse "55 8B EC 83 E4 ?? 51" or "558BEC83E4..51". Wildcards are "??", ".." or a lone "?".
+ * Returns false and sets error when a token is not hex.
+ */
+bool parseBytePattern(const QString &text, BytePattern &out, QString *error = nullptr);
+
+/**
+ * Modules whose trie pattern can match a function starting with query, in module order.
+ * Variant pattern bytes and query wildcards match anything; query bytes past the end of the
+ * pattern are not checked. Subtrees are pruned on the first mismatching byte, and a subtree
+ * entered once the query is exhausted is taken whole from its module range.
+ */
+QVector<int> findModulesByPattern(const FlirtResult &result, const BytePattern &query, int limit);
+
+} // namespace SigParser
+
+#endif // PATTERNSEARCH_H
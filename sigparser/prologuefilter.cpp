@@ -0,0 +1,118 @@
+#include "prologuefilter.h"
+#include "prologuesketch.h"
+#include "simd.h"
+#include <QtEndian>
+#include <algorithm>
+
+namespace SigParser {
+
+// Odd multipliers of the split-block Bloom filter (as in Parquet), one per block word
+static constexpr quint32 BLOOM_SALTS[8] = { 0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+                                            0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u };
+
+static bool blockContainsScalar(const quint32 *block, quint32 key) {
+    for (int i = 0; i < 8; ++i) {
+        if (!(block[i] & (1u << ((key * BLOOM_SALTS[i]) >> 27)))) return false;
+    }
+    return true;
+}
+
+#ifdef SIGPARSER_X86
+SIGPARSER_TARGET("avx2")
+static bool blockContainsAvx2(const quint32 *block, quint32 key) {
+    const __m256i salts = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(BLOOM_SALTS));
+    const __m256i bits = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(key)), salts), 27);
+    const __m256i mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), bits);
+    // testc: every bit of mask is also set in the block
+    return _mm256_testc_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(block)), mask);
+}
+#endif // SIGPARSER_X86
+
+using ContainsFn = bool (*)(const quint32 *, quint32);
+
+struct ProbeKernel {
+    ContainsFn contains;
+    const char *name;
+};
+
+static ProbeKernel selectProbeKernel() {
+#ifdef SIGPARSER_X86
+    if (cpuHasAvx2()) return { blockContainsAvx2, "avx2" };
+#endif
+    return { blockContainsScalar, "scalar" };
+}
+
+static const ProbeKernel &probeKernelImpl() {
+    static const ProbeKernel k = selectProbeKernel();
+    return k;
+}
+
+const char *PrologueFilter::probeKernel() {
+    return probeKernelImpl().name;
+}
+
+static inline qsizetype blockIndex(quint64 key, qsizetype blocks) {
+    return static_cast<qsizetype>(((key >> 32) * static_cast<quint64>(blocks)) >> 32);
+}
+
+PrologueFilter PrologueFilter::build(const FlirtResult &result) {
+    PrologueFilter filter;
+    QVector<quint64> keys;
+    bool maskUsed[256] = {};
+    keys.reserve(result.modules.size());
+    for (const FlirtModule &mod : result.modules) {
+        quint64 word = 0;
+        quint8 mask = 0;
+        modulePrologue(mod, word, mask);
+        if (mask == 0xff) return filter;  // matches anywhere
+        keys.append(prologueKey(word, mask));
+        maskUsed[mask] = true;
+    }
+    for (int m = 0; m < 256; ++m) {
+        if (maskUsed[m]) filter.m_masks.append(static_cast<quint8>(m));
+    }
+    if (keys.isEmpty() || filter.m_masks.size() > MAX_MASKS) {
+        filter.m_masks.clear();
+        return filter;
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    const qsizetype blocks = std::max<qsizetype>(1, (keys.size() * BITS_PER_KEY + 255) / 256);
+    filter.m_blocks.fill(Block{}, blocks);
+    for (quint64 key : keys) {
+        quint32 *words = filter.m_blocks[blockIndex(key, blocks)].words;
+        const quint32 low = static_cast<quint32>(key);
+        for (int i = 0; i < 8; ++i)
+            words[i] |= 1u << ((low * BLOOM_SALTS[i]) >> 27);
+    }
+    filter.m_passAll = false;
+    return filter;
+}
+
+bool PrologueFilter::probe(quint64 key) const {
+    return probeKernelImpl().contains(m_blocks[blockIndex(key, m_blocks.size())].words, static_cast<quint32>(key));
+}
+
+bool PrologueFilter::mayMatch(const char *data, qsizetype size) const {
+    // Near the end of the data the trie decides; padding rules are not worth modelling here
+    if (m_passAll || size < PrologueSketch::PROLOGUE_BYTES) return true;
+    const quint64 word = qFromLittleEndian<quint64>(data);
+    for (quint8 mask : m_masks) {
+        if (probe(prologueKey(word, mask))) return true;
+    }
+    return false;
+}
+
+QVector<qsizetype> PrologueFilter::filterOffsets(const QByteArray &image, const QVector<qsizetype> &offsets) const {
+    if (m_passAll) return offsets;
+    QVector<qsizetype> out;
+    for (qsizetype offset : offsets) {
+        if (offset < 0 || offset >= image.size()) continue;
+        if (mayMatch(image.constData() + offset, image.size() - offset))
+            out.append(offset);
+    }
+    return out;
+}
+
+} // namespace SigParser
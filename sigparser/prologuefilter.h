@@ -0,0 +1,49 @@
+#ifndef PROLOGUEFILTER_H
+#define PROLOGUEFILTER_H
+
+#include "flirtparser.h"
+
+namespace SigParser {
+
+/**
+ * Split-block Bloom filter over the prologue keys (see prologueKey()) of every module of one
+ * signature. A key selects one 256-bit block and sets one bit in each of its eight 32-bit
+ * words, so a probe touches a single half cache line and is one AVX2 multiply, shift and test.
+ * There are no false negatives: an offset the filter rejects cannot start any module match.
+ */
+class PrologueFilter
+{
+public:
+    static constexpr int BITS_PER_KEY = 16;
+    // Above this many distinct variant masks a probe costs more than the trie walk it saves
+    static constexpr int MAX_MASKS = 24;
+
+    static PrologueFilter build(const FlirtResult &result);
+
+    /** False only when no module can match data at its start. */
+    bool mayMatch(const char *data, qsizetype size) const;
+    /** Offsets of image where mayMatch() holds, in input order. */
+    QVector<qsizetype> filterOffsets(const QByteArray &image, const QVector<qsizetype> &offsets) const;
+
+    /** False when the filter passes every offset (a module with no fixed prologue byte, or too many masks). */
+    bool isSelective() const { return !m_passAll; }
+    int maskCount() const { return m_masks.size(); }
+    qsizetype memoryBytes() const { return m_blocks.size() * qsizetype(sizeof(Block)); }
+    /** Name of the probe kernel ("avx2" or "scalar"). */
+    static const char *probeKernel();
+
+private:
+    struct Block {
+        quint32 words[8];
+    };
+
+    bool probe(quint64 key) const;
+
+    QVector<Block> m_blocks;
+    QVector<quint8> m_masks;  // distinct prologue variant masks
+    bool m_passAll = true;
+};
+
+} // namespace SigParser
+
+#endif // PROLOGUEFILTER_H
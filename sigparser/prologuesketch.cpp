@@ -0,0 +1,194 @@
+#include "prologuesketch.h"
+#include <QDataStream>
+#include <QtEndian>
+#include <algorithm>
+
+namespace SigParser {
+
+static constexpr quint32 PROLOGUE_SKETCH_MAGIC = 0x46534b31;  // "FSK1"
+
+static quint64 mix64(quint64 x) {
+    // splitmix64 finaliser
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+static quint64 fixedBytesMask(quint8 variantMask) {
+    quint64 keep = 0;
+    for (int i = 0; i < PrologueSketch::PROLOGUE_BYTES; ++i) {
+        if (!(variantMask & (1u << i))) keep |= quint64(0xff) << (8 * i);
+    }
+    return keep;
+}
+
+quint64 prologueKey(quint64 word, quint8 variantMask) {
+    return mix64(mix64(word & fixedBytesMask(variantMask)) ^ variantMask);
+}
+
+int modulePrologue(const FlirtModule &mod, quint64 &word, quint8 &variantMask) {
+    word = 0;
+    variantMask = 0;
+    int n = 0;
+    for (const FlirtPatternNode &node : mod.patternPath) {
+        for (int i = 0; i < node.patternBytes.size() && n < PrologueSketch::PROLOGUE_BYTES; ++i, ++n) {
+            if (i < node.variantMask.size() && node.variantMask[i]) variantMask |= quint8(1u << n);
+            else word |= quint64(static_cast<quint8>(node.patternBytes[i])) << (8 * n);
+        }
+        if (n == PrologueSketch::PROLOGUE_BYTES) break;
+    }
+    for (int i = n; i < PrologueSketch::PROLOGUE_BYTES; ++i)
+        variantMask |= quint8(1u << i);
+    return n;
+}
+
+PrologueSketch PrologueSketch::build(const FlirtResult &result, const QString &path, int k) {
+    PrologueSketch sketch;
+    sketch.path = path;
+    sketch.libraryName = result.libraryName;
+    sketch.header.arch = result.header.arch;
+    sketch.header.fileTypes = result.header.fileTypes;
+    sketch.header.osTypes = result.header.osTypes;
+    sketch.header.appTypes = result.header.appTypes;
+
+    // (hash, mask) per module prologue; the mask is kept to rebuild keys on the image side
+    QVector<QPair<quint64, quint8>> keys;
+    keys.reserve(result.modules.size());
+    for (const FlirtModule &mod : result.modules) {
+        quint64 word = 0;
+        quint8 mask = 0;
+        const int n = modulePrologue(mod, word, mask);
+        if (n < PROLOGUE_BYTES || PROLOGUE_BYTES - qPopulationCount(mask) < PROLOGUE_MIN_FIXED) continue;
+        keys.append({ prologueKey(word, mask), mask });
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    sketch.keyCount = keys.size();
+    const int size = std::min<int>(k, keys.size());
+    sketch.hashes.reserve(size);
+    sketch.masks.reserve(size);
+    for (int i = 0; i < size; ++i) {
+        sketch.hashes.append(keys[i].first);
+        sketch.masks.append(keys[i].second);
+    }
+    return sketch;
+}
+
+QVector<qsizetype> sampleFunctionStarts(const QByteArray &image, int alignment, int maxSamples) {
+    QVector<qsizetype> starts;
+    alignment = std::max(alignment, 1);
+    const qsizetype last = image.size() - PrologueSketch::PROLOGUE_BYTES;
+    if (last < 0) return starts;
+    const qsizetype aligned = last / alignment + 1;
+    qsizetype step = alignment;
+    if (maxSamples > 0 && aligned > maxSamples)
+        step = alignment * ((aligned + maxSamples - 1) / maxSamples);
+    starts.reserve(last / step + 1);
+    for (qsizetype pos = 0; pos <= last; pos += step)
+        starts.append(pos);
+    return starts;
+}
+
+int functionAlignment(quint8 arch) {
+    switch (arch) {
+    case IDASIG_ARCH_386: return 16;
+    case IDASIG_ARCH_ARM:
+    case IDASIG_ARCH_SH:
+    case IDASIG_ARCH_68K:
+    case IDASIG_ARCH_DALVIK: return 2;
+    default: return 4;
+    }
+}
+
+QVector<SketchRank> rankSketches(const QVector<PrologueSketch> &sketches, const QByteArray &image,
+                                 const QVector<qsizetype> &starts) {
+    // All sketch hashes in one sorted table, grouped by mask so each start is hashed once per mask
+    struct Entry {
+        quint64 hash;
+        int sketch;
+    };
+    QVector<Entry> entries;
+    bool maskUsed[256] = {};
+    for (int s = 0; s < sketches.size(); ++s) {
+        for (int i = 0; i < sketches[s].hashes.size(); ++i) {
+            entries.append({ sketches[s].hashes[i], s });
+            maskUsed[sketches[s].masks[i]] = true;
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.hash < b.hash; });
+    QVector<quint8> masks;
+    for (int m = 0; m < 256; ++m) {
+        if (maskUsed[m]) masks.append(static_cast<quint8>(m));
+    }
+
+    // Each sketch hash counts once however often it occurs in the image
+    QVector<bool> found(entries.size(), false);
+    const uchar *data = reinterpret_cast<const uchar *>(image.constData());
+    for (qsizetype start : starts) {
+        if (start < 0 || start + PrologueSketch::PROLOGUE_BYTES > image.size()) continue;
+        const quint64 word = qFromLittleEndian<quint64>(data + start);
+        for (quint8 mask : masks) {
+            const quint64 key = prologueKey(word, mask);
+            auto it = std::lower_bound(entries.cbegin(), entries.cend(), key,
+                                       [](const Entry &e, quint64 h) { return e.hash < h; });
+            for (; it != entries.cend() && it->hash == key; ++it)
+                found[it - entries.cbegin()] = true;
+        }
+    }
+
+    QVector<SketchRank> ranks(sketches.size());
+    for (int s = 0; s < sketches.size(); ++s)
+        ranks[s].sketch = s;
+    for (int i = 0; i < entries.size(); ++i) {
+        if (found[i]) ++ranks[entries[i].sketch].hits;
+    }
+    QVector<SketchRank> out;
+    for (SketchRank &r : ranks) {
+        const int size = sketches[r.sketch].hashes.size();
+        if (size == 0) continue;
+        r.containment = static_cast<double>(r.hits) / size;
+        out.append(r);
+    }
+    std::stable_sort(out.begin(), out.end(), [](const SketchRank &a, const SketchRank &b) {
+        return a.containment != b.containment ? a.containment > b.containment : a.hits > b.hits;
+    });
+    return out;
+}
+
+QByteArray sketchesToBytes(const QVector<PrologueSketch> &sketches) {
+    QByteArray out;
+    QDataStream ds(&out, QIODevice::WriteOnly);
+    ds.setVersion(QDataStream::Qt_6_0);
+    ds << PROLOGUE_SKETCH_MAGIC << qint32(sketches.size());
+    for (const PrologueSketch &s : sketches) {
+        ds << s.path << s.libraryName << s.header.arch << s.header.fileTypes << s.header.osTypes
+           << s.header.appTypes << qint32(s.keyCount) << s.hashes << s.masks;
+    }
+    return out;
+}
+
+bool sketchesFromBytes(const QByteArray &bytes, QVector<PrologueSketch> &out) {
+    QDataStream ds(bytes);
+    ds.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    qint32 count = 0;
+    ds >> magic >> count;
+    if (ds.status() != QDataStream::Ok || magic != PROLOGUE_SKETCH_MAGIC || count < 0) return false;
+    QVector<PrologueSketch> sketches;
+    for (qint32 i = 0; i < count; ++i) {
+        PrologueSketch s;
+        qint32 keyCount = 0;
+        ds >> s.path >> s.libraryName >> s.header.arch >> s.header.fileTypes >> s.header.osTypes
+           >> s.header.appTypes >> keyCount >> s.hashes >> s.masks;
+        if (ds.status() != QDataStream::Ok || s.hashes.size() != s.masks.size()) return false;
+        s.keyCount = keyCount;
+        sketches.append(s);
+    }
+    out = sketches;
+    return true;
+}
+
+} // namespace SigParser
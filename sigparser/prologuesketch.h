@@ -0,0 +1,63 @@
+#ifndef PROLOGUESKETCH_H
+#define PROLOGUESKETCH_H
+
+#include "flirtparser.h"
+
+namespace SigParser {
+
+/**
+ * Bottom-k MinHash sketch of one signature's prologue keys. A key hashes the first
+ * PROLOGUE_BYTES of a module pattern together with its variant mask, variant bytes zeroed;
+ * patterns with fewer than PROLOGUE_MIN_FIXED fixed bytes there are too common to count.
+ * Keeping the k smallest hashes gives a uniform sample of the key set, so the share of them
+ * found in an image estimates how much of the signature the image contains.
+ */
+struct PrologueSketch {
+    static constexpr int PROLOGUE_BYTES = 8;
+    static constexpr int PROLOGUE_MIN_FIXED = 4;
+    static constexpr int DEFAULT_SIZE = 256;
+
+    QString path;
+    QString libraryName;
+    FlirtHeader header;        // arch and type flags only
+    int keyCount = 0;          // distinct keys the sketch was drawn from
+    QVector<quint64> hashes;   // the k smallest key hashes, ascending
+    QVector<quint8> masks;     // variant mask (bit i = byte i) per hash
+
+    static PrologueSketch build(const FlirtResult &result, const QString &path, int k = DEFAULT_SIZE);
+    bool isEmpty() const { return hashes.isEmpty(); }
+};
+
+/** Key of an 8-byte little-endian prologue word under variantMask. */
+quint64 prologueKey(quint64 word, quint8 variantMask);
+/**
+ * First PROLOGUE_BYTES of a module's pattern as a little-endian word (variant bytes zero) and
+ * its variant mask. Returns the number of pattern bytes used; missing bytes are marked variant.
+ */
+int modulePrologue(const FlirtModule &mod, quint64 &word, quint8 &variantMask);
+
+/**
+ * Candidate function starts: offsets aligned to alignment with PROLOGUE_BYTES after them.
+ * With maxSamples > 0 every n-th aligned offset is taken so that at most maxSamples remain.
+ */
+QVector<qsizetype> sampleFunctionStarts(const QByteArray &image, int alignment, int maxSamples = 0);
+/** Usual function alignment for an IDASIG_ARCH_* processor. */
+int functionAlignment(quint8 arch);
+
+struct SketchRank {
+    int sketch = -1;
+    int hits = 0;              // sketch hashes found at the starts
+    double containment = 0.0;  // hits / sketch size
+};
+
+/** Sketches ranked by estimated containment in image (best first); empty sketches are left out. */
+QVector<SketchRank> rankSketches(const QVector<PrologueSketch> &sketches, const QByteArray &image,
+                                 const QVector<qsizetype> &starts);
+
+/** Sketch file contents; sketchesFromBytes() rejects truncated or foreign data. */
+QByteArray sketchesToBytes(const QVector<PrologueSketch> &sketches);
+bool sketchesFromBytes(const QByteArray &bytes, QVector<PrologueSketch> &out);
+
+} // namespace SigParser
+
+#endif // PROLOGUESKETCH_H
@@ -0,0 +1,79 @@
+#include "sigcatalogue.h"
+#include <QDirIterator>
+#include <QFile>
+#include <QStringList>
+#include <QtConcurrent/QtConcurrentMap>
+
+namespace SigParser {
+
+// Enough for the longest header (v10) plus a 255-byte library name
+static constexpr qsizetype CATALOGUE_HEADER_BYTES = 1024;
+static constexpr quint16 APP_BITNESS = IDASIG_APP_16_BIT | IDASIG_APP_32_BIT | IDASIG_APP_64_BIT;
+static constexpr quint16 APP_KIND = IDASIG_APP_EXE | IDASIG_APP_DLL | IDASIG_APP_DRV;
+
+static CatalogueEntry readCatalogueEntry(const QString &path) {
+    CatalogueEntry e;
+    e.path = path;
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        e.error = "Cannot open file";
+        return e;
+    }
+    QByteArray data;
+    if (path.endsWith(".sig.gz", Qt::CaseInsensitive)) {
+        data = FlirtParser::decompressGzip(f.readAll());
+        if (data.isEmpty()) {
+            e.error = "Failed to decompress .sig.gz file.";
+            return e;
+        }
+    } else {
+        data = f.read(CATALOGUE_HEADER_BYTES);
+    }
+    const FlirtResult header = FlirtParser::parseHeaderOnly(data);
+    if (!header.success) {
+        e.error = header.errorMessage;
+        return e;
+    }
+    e.header = header.header;
+    e.libraryName = header.libraryName;
+    return e;
+}
+
+QVector<CatalogueEntry> scanCatalogue(const QString &dir) {
+    QStringList paths;
+    QDirIterator it(dir, QStringList() << "*.sig" << "*.sig.gz", QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+        paths << it.next();
+    paths.sort();
+    return QtConcurrent::blockingMapped<QVector<CatalogueEntry>>(paths, readCatalogueEntry);
+}
+
+QString signatureIncompatibility(const FlirtHeader &header, const BinaryInfo &binary) {
+    if (!binary.isValid()) return "unknown binary format";
+    if (header.arch != binary.arch)
+        return QString("architecture %1, binary is %2").arg(archToString(header.arch), archToString(binary.arch));
+    if (header.fileTypes && binary.fileType && !(header.fileTypes & binary.fileType))
+        return QString("file types %1").arg(fileTypesToString(header.fileTypes));
+    if (header.osTypes && binary.osType && !(header.osTypes & binary.osType))
+        return QString("OS types %1").arg(osTypesToString(header.osTypes));
+    if ((header.appTypes & APP_BITNESS) && !(header.appTypes & binary.appType & APP_BITNESS))
+        return QString("app types %1, binary is %2-bit").arg(appTypesToString(header.appTypes)).arg(binary.bits);
+    if ((header.appTypes & APP_KIND) && (binary.appType & APP_KIND) && !(header.appTypes & binary.appType & APP_KIND))
+        return QString("app types %1").arg(appTypesToString(header.appTypes));
+    return QString();
+}
+
+QVector<int> selectSignatures(const QVector<CatalogueEntry> &entries, const BinaryInfo &binary, QStringList *rejections) {
+    QVector<int> selected;
+    for (int i = 0; i < entries.size(); ++i) {
+        const CatalogueEntry &e = entries[i];
+        const QString reason = e.error.isEmpty() ? signatureIncompatibility(e.header, binary) : e.error;
+        if (reason.isEmpty())
+            selected.append(i);
+        else if (rejections)
+            *rejections << e.path + ": " + reason;
+    }
+    return selected;
+}
+
+} // namespace SigParser
@@ -0,0 +1,32 @@
+#ifndef SIGCATALOGUE_H
+#define SIGCATALOGUE_H
+
+#include "binaryinfo.h"
+
+namespace SigParser {
+
+// One signature file of a catalogue directory, known by its header only
+struct CatalogueEntry {
+    QString path;
+    QString libraryName;
+    FlirtHeader header;
+    QString error;  // set when the header could not be read
+};
+
+/** Read the headers of all .sig and .sig.gz files under dir (recursively), in parallel. */
+QVector<CatalogueEntry> scanCatalogue(const QString &dir);
+
+/**
+ * Why a signature cannot apply to a binary, or an empty string when it can: the architecture
+ * must match, and file type, OS, bitness and program kind must intersect where the signature
+ * header restricts them.
+ */
+QString signatureIncompatibility(const FlirtHeader &header, const BinaryInfo &binary);
+
+/** Indices of the readable entries compatible with binary; rejections gets "path: reason" lines. */
+QVector<int> selectSignatures(const QVector<CatalogueEntry> &entries, const BinaryInfo &binary,
+                              QStringList *rejections = nullptr);
+
+} // namespace SigParser
+
+#endif // SIGCATALOGUE_H
@@ -0,0 +1,42 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+// Helpers for kernels that pick an instruction set at run time
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SIGPARSER_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SIGPARSER_TARGET(isa) __attribute__((target(isa)))
+#else
+#define SIGPARSER_TARGET(isa)
+#endif
+
+namespace SigParser {
+
+#ifdef SIGPARSER_X86
+inline bool cpuHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7) return false;
+    __cpuid(regs, 1);
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) return false;  // OS saves YMM state
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif // SIGPARSER_X86
+
+} // namespace SigParser
+
+#endif // SIMD_H
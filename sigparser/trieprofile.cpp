@@ -0,0 +1,146 @@
+#include "trieprofile.h"
+#include <QSet>
+#include <QStringList>
+
+namespace SigParser {
+
+// Mean fan-out at which a 256-entry table wastes less than 7/8 of its slots
+static constexpr double DENSE_MIN_FANOUT = 32.0;
+// Up to this many children a linear scan over packed first bytes fits in one cache line
+static constexpr double LINEAR_MAX_FANOUT = 8.0;
+
+TrieLevelProfile::Layout TrieLevelProfile::recommendedLayout() const {
+    const double fan = fanOut.mean();
+    if (fan >= DENSE_MIN_FANOUT) return Layout::Dense;
+    if (fanOut.maxValue <= LINEAR_MAX_FANOUT) return Layout::Linear;
+    return Layout::Sparse;
+}
+
+QString TrieLevelProfile::layoutName(Layout l) {
+    switch (l) {
+    case Layout::Linear: return "linear scan";
+    case Layout::Sparse: return "sorted sparse table";
+    case Layout::Dense: return "dense 256-entry table";
+    }
+    return QString();
+}
+
+static QString histogramLine(const Histogram &h) {
+    if (!h.count) return "-";
+    QStringList buckets;
+    for (int i = 0; i < h.buckets.size(); ++i) {
+        if (h.buckets[i])
+            buckets << QString("%1:%2").arg(h.bucketLabel(i)).arg(h.buckets[i]);
+    }
+    return QString("n=%1 min=%2 mean=%3 max=%4  [%5]")
+        .arg(h.count).arg(h.minValue).arg(h.mean(), 0, 'f', 2).arg(h.maxValue).arg(buckets.join(" "));
+}
+
+QString TrieProfile::toText() const {
+    QStringList lines;
+    lines << QString("Nodes: %1  Leaves: %2  Levels: %3").arg(nodeCount).arg(leafCount).arg(levels.size());
+    lines << QString();
+    for (const TrieLevelProfile &lv : levels) {
+        lines << QString("Level %1: %2 nodes, %3 internal").arg(lv.depth).arg(lv.nodeCount).arg(lv.internalCount);
+        lines << "  Fan-out:     " + histogramLine(lv.fanOut);
+        if (lv.depth > 0)
+            lines << "  Node length: " + histogramLine(lv.nodeLength);
+        if (lv.internalCount) {
+            lines << QString("  Wildcard-first edges: %1  First-byte collisions: %2")
+                         .arg(lv.wildcardEdges).arg(lv.firstByteCollisions);
+            QString rec = "  Recommended: " + TrieLevelProfile::layoutName(lv.recommendedLayout());
+            if (lv.wildcardEdges)
+                rec += " + wildcard edge list";
+            lines << rec;
+        }
+    }
+    lines << QString();
+    lines << "Single-child chains: " + histogramLine(chainLength);
+    if (chainLength.count && chainLength.mean() > 1.0)
+        lines << QString("  Recommended: path-compress chains (mean %1 nodes)").arg(chainLength.mean(), 0, 'f', 2);
+    lines << "Subtree sizes:       " + histogramLine(subtreeSize);
+    lines << "Modules per leaf:    " + histogramLine(modulesPerLeaf);
+    lines << "CRC groups per leaf: " + histogramLine(crcGroupsPerLeaf);
+    lines << "Same-CRC group size: " + histogramLine(crcGroupSize);
+    return lines.join("\n");
+}
+
+TrieProfile computeTrieProfile(const FlirtResult &result) {
+    TrieProfile p;
+    const QVector<FlirtTreeNode> &nodes = result.nodes;
+    p.nodeCount = nodes.isEmpty() ? 0 : nodes.size() - 1;
+
+    // Nodes are in pre-order, so children always follow their parent: one reverse sweep
+    // accumulates subtree sizes.
+    QVector<quint32> subtree(nodes.size(), 1);
+    for (int i = nodes.size() - 1; i > 0; --i)
+        subtree[nodes[i].parent] += subtree[i];
+
+    for (int i = 0; i < nodes.size(); ++i) {
+        const FlirtTreeNode &n = nodes[i];
+        if (p.levels.size() <= n.depth) {
+            p.levels.resize(n.depth + 1);
+            p.levels[n.depth].depth = n.depth;
+        }
+        TrieLevelProfile &lv = p.levels[n.depth];
+        ++lv.nodeCount;
+        if (i > 0) {
+            lv.nodeLength.add(n.pattern.patternBytes.size());
+            p.subtreeSize.add(subtree[i]);
+        }
+        if (n.children.isEmpty()) {
+            if (i > 0 || result.modules.size()) ++p.leafCount;
+            continue;
+        }
+        ++lv.internalCount;
+        lv.fanOut.add(n.children.size());
+        QSet<quint8> firstBytes;
+        for (int c : n.children) {
+            const FlirtPatternNode &cp = nodes[c].pattern;
+            if (cp.variantMask.isEmpty() || cp.variantMask[0]) {
+                ++lv.wildcardEdges;
+                continue;
+            }
+            const quint8 b = static_cast<quint8>(cp.patternBytes[0]);
+            if (firstBytes.contains(b))
+                ++lv.firstByteCollisions;
+            else
+                firstBytes.insert(b);
+        }
+
+        // A chain starts at a single-child node whose parent is not single-child
+        if (n.children.size() == 1 && (n.parent < 0 || nodes[n.parent].children.size() != 1)) {
+            quint64 len = 0;
+            int c = i;
+            while (nodes[c].children.size() == 1) {
+                ++len;
+                c = nodes[c].children.first();
+            }
+            p.chainLength.add(len);
+        }
+    }
+
+    // Modules sharing a leaf are contiguous, and same-CRC groups are contiguous within a leaf
+    for (int mi = 0; mi < result.modules.size();) {
+        const int leaf = result.modules[mi].leafNode;
+        quint64 modulesAtLeaf = 0;
+        quint64 groups = 0;
+        while (mi < result.modules.size() && result.modules[mi].leafNode == leaf) {
+            const FlirtModule &first = result.modules[mi];
+            quint64 groupSize = 0;
+            while (mi < result.modules.size() && result.modules[mi].leafNode == leaf
+                   && result.modules[mi].crcLength == first.crcLength && result.modules[mi].crc16 == first.crc16) {
+                ++groupSize;
+                ++mi;
+            }
+            p.crcGroupSize.add(groupSize);
+            modulesAtLeaf += groupSize;
+            ++groups;
+        }
+        p.modulesPerLeaf.add(modulesAtLeaf);
+        p.crcGroupsPerLeaf.add(groups);
+    }
+    return p;
+}
+
+} // namespace SigParser
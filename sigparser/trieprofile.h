@@ -0,0 +1,41 @@
+#ifndef TRIEPROFILE_H
+#define TRIEPROFILE_H
+
+#include "flirtstats.h"
+
+namespace SigParser {
+
+// Shape of one trie level (all nodes at the same depth)
+struct TrieLevelProfile {
+    int depth = 0;
+    quint64 nodeCount = 0;
+    quint64 internalCount = 0;
+    quint64 wildcardEdges = 0;      // children whose first byte is variant (cannot be table-indexed)
+    quint64 firstByteCollisions = 0; // siblings sharing the same fixed first byte
+    Histogram fanOut = Histogram(Histogram::Scale::Log2, 10);        // children per internal node
+    Histogram nodeLength = Histogram(Histogram::Scale::Linear, 65);  // bytes per node at this depth
+
+    enum class Layout { Linear, Sparse, Dense };
+    Layout recommendedLayout() const;
+    static QString layoutName(Layout l);
+};
+
+struct TrieProfile {
+    QVector<TrieLevelProfile> levels;
+    Histogram chainLength = Histogram(Histogram::Scale::Linear, 17);     // runs of single-child nodes
+    Histogram subtreeSize = Histogram(Histogram::Scale::Log2, 24);       // nodes per subtree
+    Histogram modulesPerLeaf = Histogram(Histogram::Scale::Linear, 33);
+    Histogram crcGroupsPerLeaf = Histogram(Histogram::Scale::Linear, 17);
+    Histogram crcGroupSize = Histogram(Histogram::Scale::Linear, 17);     // modules sharing one CRC at a leaf
+    quint64 nodeCount = 0;
+    quint64 leafCount = 0;
+
+    /** Human readable report with per-level layout recommendations. */
+    QString toText() const;
+};
+
+TrieProfile computeTrieProfile(const FlirtResult &result);
+
+} // namespace SigParser
+
+#endif // TRIEPROFILE_H
@@ -0,0 +1,129 @@
+#include "statisticswidget.h"
+#include <QComboBox>
+#include <QLabel>
+#include <QPainter>
+#include <QScrollArea>
+#include <QVBoxLayout>
+
+// Horizontal bar chart: one row per bucket between the first and last non-empty bucket
+class HistogramChart : public QWidget
+{
+public:
+    explicit HistogramChart(QWidget *parent = nullptr) : QWidget(parent) {}
+
+    void setHistogram(const SigParser::Histogram &h)
+    {
+        m_hist = h;
+        m_first = 0;
+        m_last = -1;
+        for (int i = 0; i < h.buckets.size(); ++i) {
+            if (!h.buckets[i]) continue;
+            if (m_last < 0) m_first = i;
+            m_last = i;
+        }
+        updateGeometry();
+        update();
+    }
+
+    QSize sizeHint() const override
+    {
+        const int rows = m_last >= m_first ? m_last - m_first + 1 : 0;
+        return QSize(200, rows * rowHeight() + 4);
+    }
+
+    QSize minimumSizeHint() const override { return sizeHint(); }
+
+protected:
+    void paintEvent(QPaintEvent *) override
+    {
+        if (m_last < m_first) return;
+        QPainter p(this);
+        const QFontMetrics fm = fontMetrics();
+        quint64 peak = 0;
+        int labelWidth = 0;
+        int countWidth = 0;
+        for (int i = m_first; i <= m_last; ++i) {
+            peak = qMax(peak, m_hist.buckets[i]);
+            labelWidth = qMax(labelWidth, fm.horizontalAdvance(m_hist.bucketLabel(i)));
+            countWidth = qMax(countWidth, fm.horizontalAdvance(QString::number(m_hist.buckets[i])));
+        }
+        const int barLeft = labelWidth + 8;
+        const int barMax = qMax(1, width() - barLeft - countWidth - 8);
+        const QColor barColor = palette().color(QPalette::Highlight);
+        int y = 2;
+        for (int i = m_first; i <= m_last; ++i, y += rowHeight()) {
+            const quint64 n = m_hist.buckets[i];
+            const QRect labelRect(0, y, labelWidth + 4, rowHeight());
+            p.setPen(palette().color(QPalette::WindowText));
+            p.drawText(labelRect, Qt::AlignRight | Qt::AlignVCenter, m_hist.bucketLabel(i));
+            const int w = peak ? static_cast<int>(static_cast<double>(n) * barMax / peak) : 0;
+            p.fillRect(barLeft, y + 2, qMax(w, n ? 1 : 0), rowHeight() - 4, barColor);
+            p.drawText(QRect(barLeft + w + 4, y, countWidth + 4, rowHeight()), Qt::AlignLeft | Qt::AlignVCenter, QString::number(n));
+        }
+    }
+
+private:
+    int rowHeight() const { return fontMetrics().height() + 4; }
+
+    SigParser::Histogram m_hist;
+    int m_first = 0;
+    int m_last = -1;
+};
+
+StatisticsWidget::StatisticsWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    m_metricCombo = new QComboBox();
+    for (int i = 0; i < SigParser::FlirtStatistics::MetricCount; ++i)
+        m_metricCombo->addItem(SigParser::FlirtStatistics::metricName(static_cast<SigParser::FlirtStatistics::Metric>(i)));
+    layout->addWidget(m_metricCombo);
+    m_summaryLabel = new QLabel();
+    m_summaryLabel->setWordWrap(true);
+    layout->addWidget(m_summaryLabel);
+    m_chart = new HistogramChart();
+    QScrollArea *scroll = new QScrollArea();
+    scroll->setWidget(m_chart);
+    scroll->setWidgetResizable(true);
+    scroll->setFrameShape(QFrame::NoFrame);
+    layout->addWidget(scroll, 1);
+    connect(m_metricCombo, &QComboBox::currentIndexChanged, this, &StatisticsWidget::onMetricChanged);
+    clear();
+}
+
+void StatisticsWidget::setStatistics(const SigParser::FlirtStatistics &stats)
+{
+    m_stats = stats;
+    m_hasStats = true;
+    onMetricChanged(m_metricCombo->currentIndex());
+}
+
+void StatisticsWidget::setBusy()
+{
+    m_hasStats = false;
+    m_summaryLabel->setText(tr("Computing..."));
+    m_chart->setHistogram(SigParser::Histogram());
+}
+
+void StatisticsWidget::clear()
+{
+    m_hasStats = false;
+    m_summaryLabel->setText(tr("No signature loaded"));
+    m_chart->setHistogram(SigParser::Histogram());
+}
+
+void StatisticsWidget::onMetricChanged(int index)
+{
+    if (!m_hasStats || index < 0 || index >= SigParser::FlirtStatistics::MetricCount)
+        return;
+    const SigParser::Histogram &h = m_stats.histograms[index];
+    QStringList lines;
+    lines << tr("Modules: %1  Functions: %2  Nodes: %3")
+                 .arg(m_stats.moduleCount).arg(m_stats.functionCount).arg(m_stats.nodeCount);
+    if (h.count)
+        lines << tr("Samples: %1  Min: %2  Max: %3  Mean: %4")
+                     .arg(h.count).arg(h.minValue).arg(h.maxValue).arg(h.mean(), 0, 'f', 2);
+    m_summaryLabel->setText(lines.join("\n"));
+    m_chart->setHistogram(h);
+}
@@ -0,0 +1,33 @@
+#ifndef STATISTICSWIDGET_H
+#define STATISTICSWIDGET_H
+
+#include <QWidget>
+#include "sigparser/flirtstats.h"
+
+class QComboBox;
+class QLabel;
+class HistogramChart;
+
+class StatisticsWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit StatisticsWidget(QWidget *parent = nullptr);
+
+    void setStatistics(const SigParser::FlirtStatistics &stats);
+    void setBusy();
+    void clear();
+
+private slots:
+    void onMetricChanged(int index);
+
+private:
+    SigParser::FlirtStatistics m_stats;
+    bool m_hasStats = false;
+    QComboBox *m_metricCombo;
+    QLabel *m_summaryLabel;
+    HistogramChart *m_chart;
+};
+
+#endif // STATISTICSWIDGET_H
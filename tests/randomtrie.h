@@ -0,0 +1,90 @@
+#ifndef RANDOMTRIE_H
+#define RANDOMTRIE_H
+
+#include "sigparser/flirtparser.h"
+#include <random>
+
+// A FlirtResult shaped like parser output: nodes in pre-order with the root first, modules in
+// DFS leaf order, every module carrying its pattern path. About variantPercent of the pattern
+// bytes are variant.
+class RandomTrie
+{
+public:
+    static SigParser::FlirtResult build(quint32 seed, int maxNodes, int maxPatternLength = 8, int variantPercent = 20)
+    {
+        RandomTrie t(seed, maxNodes, maxPatternLength, variantPercent);
+        t.m_result.nodes.append(SigParser::FlirtTreeNode());
+        t.grow(0);
+        t.m_result.success = true;
+        return t.m_result;
+    }
+
+private:
+    RandomTrie(quint32 seed, int maxNodes, int maxPatternLength, int variantPercent)
+        : m_rng(seed), m_maxNodes(maxNodes), m_maxPatternLength(maxPatternLength), m_variantPercent(variantPercent) {}
+
+    void grow(int id)
+    {
+        m_result.nodes[id].moduleBegin = m_result.modules.size();
+        const int depth = m_result.nodes[id].depth;
+        int fanout = depth >= 6 || m_result.nodes.size() >= m_maxNodes ? 0 : static_cast<int>(m_rng() % 4);
+        if (id == 0 && m_maxNodes > 1) fanout = 4 + static_cast<int>(m_rng() % 12);  // a wide root, as in real files
+        for (int c = 0; c < fanout; ++c) {
+            SigParser::FlirtTreeNode child;
+            child.parent = id;
+            child.depth = depth + 1;
+            const int length = 1 + static_cast<int>(m_rng() % m_maxPatternLength);
+            for (int i = 0; i < length; ++i) {
+                const bool variant = static_cast<int>(m_rng() % 100) < m_variantPercent;
+                child.pattern.patternBytes.append(variant ? '\0' : static_cast<char>(m_rng()));
+                child.pattern.variantMask.append(variant ? '\1' : '\0');
+            }
+            const int childId = m_result.nodes.size();
+            m_result.nodes.append(child);
+            m_result.nodes[id].children.append(childId);
+            m_path.append(child.pattern);
+            grow(childId);
+            m_path.removeLast();
+        }
+        if (fanout == 0) {
+            const int modules = 1 + static_cast<int>(m_rng() % 3);
+            for (int i = 0; i < modules; ++i) {
+                SigParser::FlirtModule mod;
+                mod.patternPath = m_path;
+                mod.leafNode = id;
+                for (const SigParser::FlirtPatternNode &node : m_path) {
+                    mod.patternLength += node.patternBytes.size();
+                    for (char v : node.variantMask)
+                        mod.patternFixedBytes += v ? 0 : 1;
+                }
+                SigParser::FlirtFunction f;
+                f.name = QString("f%1").arg(m_result.modules.size());
+                mod.publicFunctions.append(f);
+                m_result.modules.append(mod);
+            }
+        }
+        m_result.nodes[id].moduleEnd = m_result.modules.size();
+    }
+
+    std::mt19937 m_rng;
+    int m_maxNodes;
+    int m_maxPatternLength;
+    int m_variantPercent;
+    SigParser::FlirtResult m_result;
+    QVector<SigParser::FlirtPatternNode> m_path;
+};
+
+// Bytes that satisfy a module's pattern, with variant positions filled at random
+inline QByteArray modulePatternBytes(const SigParser::FlirtModule &mod, std::mt19937 &rng)
+{
+    QByteArray out;
+    for (const SigParser::FlirtPatternNode &node : mod.patternPath) {
+        for (int i = 0; i < node.patternBytes.size(); ++i) {
+            const bool variant = i < node.variantMask.size() && node.variantMask[i];
+            out += variant ? static_cast<char>(rng()) : node.patternBytes[i];
+        }
+    }
+    return out;
+}
+
+#endif // RANDOMTRIE_H
@@ -0,0 +1,127 @@
+#include <QtTest>
+#include "randomtrie.h"
+#include "sigparser/compacttrie.h"
+#include "sigparser/flirtmatcher.h"
+
+using namespace SigParser;
+
+class TestCompactTrie : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void rankSelectMatchesNaive_data();
+    void rankSelectMatchesNaive();
+    void navigationMatchesFlatTrie();
+    void matchAgreesWithFlatEncoding();
+};
+
+void TestCompactTrie::rankSelectMatchesNaive_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<int>("onePercent");
+    for (int size : { 0, 1, 63, 64, 65, 511, 512, 513, 4097 }) {
+        for (int density : { 0, 3, 50, 97, 100 })
+            QTest::addRow("%d bits, %d%% ones", size, density) << size << density;
+    }
+}
+
+void TestCompactTrie::rankSelectMatchesNaive()
+{
+    QFETCH(int, size);
+    QFETCH(int, onePercent);
+    std::mt19937 rng(size * 131 + onePercent);
+    QVector<bool> bits;
+    RankSelectBits rs;
+    for (int i = 0; i < size; ++i) {
+        const bool bit = static_cast<int>(rng() % 100) < onePercent;
+        bits.append(bit);
+        rs.append(bit);
+    }
+    rs.finish();
+    QCOMPARE(rs.size(), qsizetype(size));
+
+    QVector<qsizetype> ones;
+    QVector<qsizetype> zeros;
+    for (int pos = 0; pos <= size; ++pos) {
+        QCOMPARE(rs.rank1(pos), qsizetype(ones.size()));
+        QCOMPARE(rs.rank0(pos), qsizetype(zeros.size()));
+        if (pos == size) break;
+        QCOMPARE(rs.at(pos), bits[pos]);
+        (bits[pos] ? ones : zeros).append(pos);
+    }
+    for (int k = 0; k < ones.size(); ++k)
+        QCOMPARE(rs.select1(k), ones[k]);
+    for (int k = 0; k < zeros.size(); ++k)
+        QCOMPARE(rs.select0(k), zeros[k]);
+    QCOMPARE(rs.select1(ones.size()), qsizetype(-1));
+    QCOMPARE(rs.select0(zeros.size()), qsizetype(-1));
+}
+
+void TestCompactTrie::navigationMatchesFlatTrie()
+{
+    for (quint32 seed = 1; seed <= 20; ++seed) {
+        const FlirtResult result = RandomTrie::build(seed, 2000);
+        const CompactTrie trie = CompactTrie::build(result);
+        QCOMPARE(trie.nodeCount(), int(result.nodes.size()));
+
+        // LOUDS ids are level order; rebuild that order from the pre-order arena
+        QVector<int> order{ 0 };
+        for (int i = 0; i < order.size(); ++i)
+            order += result.nodes[order[i]].children;
+        QVector<int> loudsId(result.nodes.size());
+        for (int i = 0; i < order.size(); ++i)
+            loudsId[order[i]] = i;
+
+        for (int id = 0; id < order.size(); ++id) {
+            const FlirtTreeNode &node = result.nodes[order[id]];
+            QCOMPARE(trie.childCount(id), int(node.children.size()));
+            QCOMPARE(trie.isLeaf(id), node.children.isEmpty());
+            if (node.children.isEmpty()) {
+                QCOMPARE(trie.firstChild(id), -1);
+                QCOMPARE(trie.leafModuleBegin(id), node.moduleBegin);
+                QCOMPARE(trie.leafModuleEnd(id), node.moduleEnd);
+            } else {
+                const int first = trie.firstChild(id);
+                for (int c = 0; c < node.children.size(); ++c) {
+                    QCOMPARE(loudsId[node.children[c]], first + c);
+                    QCOMPARE(trie.parent(first + c), id);
+                }
+            }
+            const FlirtPatternNode p = trie.pattern(id);
+            QCOMPARE(trie.patternLength(id), int(node.pattern.patternBytes.size()));
+            QCOMPARE(p.patternBytes, node.pattern.patternBytes);
+            for (int i = 0; i < p.patternBytes.size(); ++i)
+                QCOMPARE(bool(p.variantMask[i]), i < node.pattern.variantMask.size() && node.pattern.variantMask[i]);
+        }
+    }
+}
+
+void TestCompactTrie::matchAgreesWithFlatEncoding()
+{
+    for (quint32 seed = 1; seed <= 10; ++seed) {
+        const FlirtResult result = RandomTrie::build(seed, 3000);
+        const FlirtMatcher flat = FlirtMatcher::compile(result, FlirtMatcher::Encoding::Flat);
+        const FlirtMatcher compact = FlirtMatcher::compile(result, FlirtMatcher::Encoding::Compact);
+        QVERIFY(compact.isCompact());
+        QVERIFY(compact.result().modules.first().patternPath.isEmpty());
+        QCOMPARE(compact.result().modules.first().patternLength, result.modules.first().patternLength);
+
+        std::mt19937 rng(seed);
+        for (int i = 0; i < 200; ++i) {
+            QByteArray data = modulePatternBytes(result.modules[rng() % result.modules.size()], rng);
+            if (i % 4 == 0 && !data.isEmpty()) data[rng() % data.size()] ^= 0x5a;  // near miss
+            data += QByteArray(16, '\x90');
+            const QVector<FlirtMatcher::Candidate> expected = flat.match(data);
+            const QVector<FlirtMatcher::Candidate> actual = compact.match(data);
+            QCOMPARE(actual.size(), expected.size());
+            for (int c = 0; c < actual.size(); ++c) {
+                QCOMPARE(actual[c].module, expected[c].module);
+                QVERIFY(actual[c].failed == expected[c].failed);
+            }
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(TestCompactTrie)
+#include "tst_compacttrie.moc"
@@ -0,0 +1,102 @@
+#include <QtTest>
+#include "sigparser/frontcodeddict.h"
+#include <algorithm>
+#include <random>
+
+using namespace SigParser;
+
+// Sorted, unique strings with long shared prefixes, like mangled names
+static QVector<QByteArray> sampleStrings(int count, quint32 seed)
+{
+    std::mt19937 rng(seed);
+    static const char *stems[] = { "", "?", "??0", "??_G", "_", "__imp_", "std::", "\xff", "\xff\xff" };
+    QVector<QByteArray> out;
+    while (out.size() < count) {
+        QByteArray s = stems[rng() % (sizeof(stems) / sizeof(stems[0]))];
+        const int extra = static_cast<int>(rng() % 12);
+        for (int i = 0; i < extra; ++i)
+            s += static_cast<char>(rng() % 4 == 0 ? rng() : 'a' + rng() % 6);
+        out.append(s);
+        if (rng() % 8 == 0) out.append(s);  // duplicates are removed by fromUnsorted()
+    }
+    return out;
+}
+
+static QVector<QByteArray> sortedUnique(QVector<QByteArray> strings)
+{
+    std::sort(strings.begin(), strings.end());
+    strings.erase(std::unique(strings.begin(), strings.end()), strings.end());
+    return strings;
+}
+
+class TestFrontCodedDictionary : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTrip_data();
+    void roundTrip();
+    void rejectsDamagedBytes();
+};
+
+void TestFrontCodedDictionary::roundTrip_data()
+{
+    QTest::addColumn<int>("count");
+    for (int count : { 0, 1, 15, 16, 17, 33, 1000 })
+        QTest::addRow("%d strings", count) << count;
+}
+
+void TestFrontCodedDictionary::roundTrip()
+{
+    QFETCH(int, count);
+    const QVector<QByteArray> input = sampleStrings(count, count + 7);
+    const QVector<QByteArray> sorted = sortedUnique(input);
+    const FrontCodedDictionary dict = FrontCodedDictionary::fromUnsorted(input);
+    QCOMPARE(dict.size(), int(sorted.size()));
+
+    for (int id = 0; id < sorted.size(); ++id) {
+        QCOMPARE(dict.at(id), sorted[id]);
+        QCOMPARE(dict.find(sorted[id]), id);
+    }
+    QCOMPARE(dict.range(0, dict.size()), sorted);
+    if (sorted.size() > 20)
+        QCOMPARE(dict.range(5, 20), sorted.mid(5, 15));
+    QCOMPARE(dict.find("not in the sample"), -1);
+
+    // Every prefix of every string, plus a few that match nothing
+    QVector<QByteArray> prefixes{ QByteArray(), QByteArray("\xff"), QByteArray("zzz"), QByteArray("?\xff") };
+    for (const QByteArray &s : sorted) {
+        for (int n = 0; n <= s.size(); ++n)
+            prefixes.append(s.left(n));
+    }
+    for (const QByteArray &prefix : prefixes) {
+        const auto first = std::lower_bound(sorted.cbegin(), sorted.cend(), prefix) - sorted.cbegin();
+        auto last = first;
+        while (last < sorted.size() && sorted[last].startsWith(prefix))
+            ++last;
+        const QPair<int, int> range = dict.prefixRange(prefix);
+        QCOMPARE(range.first, int(first));
+        QCOMPARE(range.second, int(last));
+    }
+
+    FrontCodedDictionary loaded;
+    QVERIFY(FrontCodedDictionary::fromBytes(dict.toBytes(), loaded));
+    QCOMPARE(loaded.size(), dict.size());
+    QCOMPARE(loaded.range(0, loaded.size()), sorted);
+    QCOMPARE(loaded.toBytes(), dict.toBytes());
+}
+
+void TestFrontCodedDictionary::rejectsDamagedBytes()
+{
+    const QByteArray bytes = FrontCodedDictionary::fromUnsorted(sampleStrings(100, 3)).toBytes();
+    FrontCodedDictionary out;
+    for (int n = 0; n < bytes.size(); ++n)
+        QVERIFY2(!FrontCodedDictionary::fromBytes(bytes.left(n), out), qPrintable(QString("truncated to %1").arg(n)));
+    QByteArray badMagic = bytes;
+    badMagic[0] = 'X';
+    QVERIFY(!FrontCodedDictionary::fromBytes(badMagic, out));
+    QVERIFY(!FrontCodedDictionary::fromBytes(bytes + 'x', out));
+}
+
+QTEST_GUILESS_MAIN(TestFrontCodedDictionary)
+#include "tst_frontcodeddict.moc"
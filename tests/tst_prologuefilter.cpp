@@ -0,0 +1,76 @@
+#include <QtTest>
+#include "randomtrie.h"
+#include "sigparser/prologuefilter.h"
+
+using namespace SigParser;
+
+class TestPrologueFilter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void noFalseNegatives_data();
+    void noFalseNegatives();
+};
+
+void TestPrologueFilter::noFalseNegatives_data()
+{
+    QTest::addColumn<quint32>("seed");
+    QTest::addColumn<int>("maxNodes");
+    QTest::addColumn<int>("maxPatternLength");
+    QTest::addColumn<int>("variantPercent");
+    for (quint32 seed : { 1u, 2u, 3u }) {
+        QTest::addRow("single bytes, seed %u", seed) << seed << 40 << 1 << 0;
+        QTest::addRow("short patterns, seed %u", seed) << seed << 60 << 3 << 0;
+        QTest::addRow("large trie, seed %u", seed) << seed << 3000 << 8 << 0;
+        QTest::addRow("variant bytes, seed %u", seed) << seed << 60 << 4 << 10;
+        QTest::addRow("large trie with variants, seed %u", seed) << seed << 3000 << 3 << 5;
+    }
+}
+
+void TestPrologueFilter::noFalseNegatives()
+{
+    QFETCH(quint32, seed);
+    QFETCH(int, maxNodes);
+    QFETCH(int, maxPatternLength);
+    QFETCH(int, variantPercent);
+    const FlirtResult result = RandomTrie::build(seed, maxNodes, maxPatternLength, variantPercent);
+    const PrologueFilter filter = PrologueFilter::build(result);
+    // Without variant bytes the only masks are the padding of short patterns
+    if (variantPercent == 0) QVERIFY(filter.isSelective());
+
+    std::mt19937 rng(seed);
+    QByteArray image;
+    QVector<qsizetype> offsets;
+    int shortPatterns = 0;
+    for (int round = 0; round < 3; ++round) {
+        for (int mi = 0; mi < result.modules.size(); ++mi) {
+            const QByteArray pattern = modulePatternBytes(result.modules[mi], rng);
+            if (pattern.size() < 8) ++shortPatterns;
+            QVERIFY2(filter.mayMatch(pattern.constData(), pattern.size()), qPrintable(QString("module %1 alone").arg(mi)));
+            QByteArray data = pattern;
+            for (int i = 0; i < 16; ++i)
+                data += static_cast<char>(rng());
+            QVERIFY2(filter.mayMatch(data.constData(), data.size()), qPrintable(QString("module %1").arg(mi)));
+            offsets.append(image.size());
+            image += data;
+        }
+    }
+    QCOMPARE(filter.filterOffsets(image, offsets), offsets);
+    if (maxPatternLength < 8) QVERIFY(shortPatterns > 0);
+
+    // A filter that passed everything would make the checks above vacuous
+    if (filter.isSelective()) {
+        int rejected = 0;
+        for (int i = 0; i < 1000; ++i) {
+            char word[8];
+            for (char &b : word)
+                b = static_cast<char>(rng());
+            rejected += !filter.mayMatch(word, sizeof(word));
+        }
+        QVERIFY(rejected > 0);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestPrologueFilter)
+#include "tst_prologuefilter.moc"